@@ -0,0 +1,756 @@
+/*
+    File:   Array.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 21:13:52 2026
+
+    Description:
+       Psil typed numeric arrays.
+
+       An array holds a fixed number of unboxed "F64" (double) or "I64"
+       (64-bit integer) elements contiguously, so numeric data costs 8
+       bytes per element, rather than a cons and (usually) a boxed number.
+       Elements are converted to and from forms only by "aref" and "aset";
+       the whole-array operations run directly over the elements.
+
+       The element-wise and reduction kernels come in scalar, SSE2 and AVX2
+       versions, and the best one the processor supports is selected the
+       first time one is needed.  (SSE2 has no 64-bit integer comparison,
+       and neither SSE2 nor AVX2 has a 64-bit integer multiply, so those
+       kernels fall back to scalar code.)  The vector kernels sum in several
+       lanes at once, so flonum sums may round differently than in order.
+       Integer arithmetic on I64 arrays wraps around, as in C.
+
+       F64 elements are stored and computed as doubles, but "aref" and
+       the flonum reductions return them as flonums, which are floats
+       unless FLONUM_IS_DOUBLE is defined, so their results are rounded
+       to single precision in the default build.
+
+       The transcendental functions are computed element by element with
+       the C library, so their results agree exactly with "sin", "exp" and
+       "ln" of the elements.
+
+       Define NO_SIMD to use the scalar kernels only.
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Psil.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(NO_SIMD)
+#define SIMD_KERNELS 1
+#include <immintrin.h>
+#else
+#define SIMD_KERNELS 0
+#endif // defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(NO_SIMD)
+
+
+// Define macros.
+
+
+// (The vector kernels are compiled for their instruction sets regardless of the compiler's target.)
+#define SSE2_KERNEL __attribute__((target("sse2")))
+#define AVX2_KERNEL __attribute__((target("avx2")))
+
+
+// Define types.
+
+
+typedef struct ArrayKernels {
+    const char  *name;
+    void        (*addF64)(const double *x, const double *y, double *r, long n);
+    void        (*multiplyF64)(const double *x, const double *y, double *r, long n);
+    double      (*dotF64)(const double *x, const double *y, long n);
+    double      (*sumF64)(const double *x, long n);
+    double      (*minF64)(const double *x, long n);
+    double      (*maxF64)(const double *x, long n);
+    void        (*addI64)(const PsilInteger *x, const PsilInteger *y, PsilInteger *r, long n);
+    PsilInteger (*sumI64)(const PsilInteger *x, long n);
+    PsilInteger (*minI64)(const PsilInteger *x, long n);
+    PsilInteger (*maxI64)(const PsilInteger *x, long n);
+} ArrayKernels;
+
+
+// Define functions.
+
+
+// Scalar kernels:
+// (Integer arithmetic is done unsigned, so that it wraps around rather than being undefined.)
+
+static void AddF64(const double *x, const double *y, double *r, long n)
+{
+    for (long i = 0; i < n; i++)
+      r[i] = x[i] + y[i];
+}
+
+static void MultiplyF64(const double *x, const double *y, double *r, long n)
+{
+    for (long i = 0; i < n; i++)
+      r[i] = x[i] * y[i];
+}
+
+static double DotF64(const double *x, const double *y, long n)
+{
+    double sum = 0.0;
+
+    for (long i = 0; i < n; i++)
+      sum += x[i] * y[i];
+
+    return sum;
+}
+
+static double SumF64(const double *x, long n)
+{
+    double sum = 0.0;
+
+    for (long i = 0; i < n; i++)
+      sum += x[i];
+
+    return sum;
+}
+
+// (These are only called on non-empty arrays.)
+
+static double MinF64(const double *x, long n)
+{
+    double min = x[0];
+
+    for (long i = 1; i < n; i++)
+      min = (x[i] < min) ? x[i] : min;
+
+    return min;
+}
+
+static double MaxF64(const double *x, long n)
+{
+    double max = x[0];
+
+    for (long i = 1; i < n; i++)
+      max = (x[i] > max) ? x[i] : max;
+
+    return max;
+}
+
+static void AddI64(const PsilInteger *x, const PsilInteger *y, PsilInteger *r, long n)
+{
+    for (long i = 0; i < n; i++)
+      r[i] = (PsilInteger) ((uint64_t) x[i] + (uint64_t) y[i]);
+}
+
+static void MultiplyI64(const PsilInteger *x, const PsilInteger *y, PsilInteger *r, long n)
+{
+    for (long i = 0; i < n; i++)
+      r[i] = (PsilInteger) ((uint64_t) x[i] * (uint64_t) y[i]);
+}
+
+static PsilInteger DotI64(const PsilInteger *x, const PsilInteger *y, long n)
+{
+    uint64_t sum = 0;
+
+    for (long i = 0; i < n; i++)
+      sum += (uint64_t) x[i] * (uint64_t) y[i];
+
+    return (PsilInteger) sum;
+}
+
+static PsilInteger SumI64(const PsilInteger *x, long n)
+{
+    uint64_t sum = 0;
+
+    for (long i = 0; i < n; i++)
+      sum += (uint64_t) x[i];
+
+    return (PsilInteger) sum;
+}
+
+static PsilInteger MinI64(const PsilInteger *x, long n)
+{
+    PsilInteger min = x[0];
+
+    for (long i = 1; i < n; i++)
+      min = (x[i] < min) ? x[i] : min;
+
+    return min;
+}
+
+static PsilInteger MaxI64(const PsilInteger *x, long n)
+{
+    PsilInteger max = x[0];
+
+    for (long i = 1; i < n; i++)
+      max = (x[i] > max) ? x[i] : max;
+
+    return max;
+}
+
+static const ArrayKernels ScalarKernels = {
+    "scalar", AddF64, MultiplyF64, DotF64, SumF64, MinF64, MaxF64, AddI64, SumI64, MinI64, MaxI64
+};
+
+#if SIMD_KERNELS
+
+// SSE2 kernels (two lanes):
+
+SSE2_KERNEL static void AddF64SSE2(const double *x, const double *y, double *r, long n)
+{
+    long i = 0;
+
+    for ( ; i + 2 <= n; i += 2)
+      _mm_storeu_pd(r + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+
+    AddF64(x + i, y + i, r + i, n - i);
+}
+
+SSE2_KERNEL static void MultiplyF64SSE2(const double *x, const double *y, double *r, long n)
+{
+    long i = 0;
+
+    for ( ; i + 2 <= n; i += 2)
+      _mm_storeu_pd(r + i, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+
+    MultiplyF64(x + i, y + i, r + i, n - i);
+}
+
+SSE2_KERNEL static double DotF64SSE2(const double *x, const double *y, long n)
+{
+    __m128d sum = _mm_setzero_pd();
+    double lanes[2];
+    long i = 0;
+
+    for ( ; i + 2 <= n; i += 2)
+      sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+
+    _mm_storeu_pd(lanes, sum);
+
+    return lanes[0] + lanes[1] + DotF64(x + i, y + i, n - i);
+}
+
+SSE2_KERNEL static double SumF64SSE2(const double *x, long n)
+{
+    __m128d sum = _mm_setzero_pd();
+    double lanes[2];
+    long i = 0;
+
+    for ( ; i + 2 <= n; i += 2)
+      sum = _mm_add_pd(sum, _mm_loadu_pd(x + i));
+
+    _mm_storeu_pd(lanes, sum);
+
+    return lanes[0] + lanes[1] + SumF64(x + i, n - i);
+}
+
+SSE2_KERNEL static double MinF64SSE2(const double *x, long n)
+{
+    double lanes[2];
+    long i = 2;
+
+    if (n < 2)
+      return x[0];
+
+    __m128d min = _mm_loadu_pd(x);
+    for ( ; i + 2 <= n; i += 2)
+      min = _mm_min_pd(_mm_loadu_pd(x + i), min);
+
+    _mm_storeu_pd(lanes, min);
+    double result = MinF64(lanes, 2);
+
+    for ( ; i < n; i++)
+      result = (x[i] < result) ? x[i] : result;
+
+    return result;
+}
+
+SSE2_KERNEL static double MaxF64SSE2(const double *x, long n)
+{
+    double lanes[2];
+    long i = 2;
+
+    if (n < 2)
+      return x[0];
+
+    __m128d max = _mm_loadu_pd(x);
+    for ( ; i + 2 <= n; i += 2)
+      max = _mm_max_pd(_mm_loadu_pd(x + i), max);
+
+    _mm_storeu_pd(lanes, max);
+    double result = MaxF64(lanes, 2);
+
+    for ( ; i < n; i++)
+      result = (x[i] > result) ? x[i] : result;
+
+    return result;
+}
+
+SSE2_KERNEL static void AddI64SSE2(const PsilInteger *x, const PsilInteger *y, PsilInteger *r, long n)
+{
+    long i = 0;
+
+    for ( ; i + 2 <= n; i += 2)
+      _mm_storeu_si128((__m128i *) (r + i), _mm_add_epi64(_mm_loadu_si128((const __m128i *) (x + i)),
+                                                          _mm_loadu_si128((const __m128i *) (y + i))));
+
+    AddI64(x + i, y + i, r + i, n - i);
+}
+
+SSE2_KERNEL static PsilInteger SumI64SSE2(const PsilInteger *x, long n)
+{
+    __m128i sum = _mm_setzero_si128();
+    PsilInteger lanes[2];
+    long i = 0;
+
+    for ( ; i + 2 <= n; i += 2)
+      sum = _mm_add_epi64(sum, _mm_loadu_si128((const __m128i *) (x + i)));
+
+    _mm_storeu_si128((__m128i *) lanes, sum);
+
+    return (PsilInteger) ((uint64_t) lanes[0] + (uint64_t) lanes[1] + (uint64_t) SumI64(x + i, n - i));
+}
+
+static const ArrayKernels SSE2Kernels = {
+    "sse2", AddF64SSE2, MultiplyF64SSE2, DotF64SSE2, SumF64SSE2, MinF64SSE2, MaxF64SSE2,
+    AddI64SSE2, SumI64SSE2, MinI64, MaxI64
+};
+
+// AVX2 kernels (four lanes, with two accumulators for the sums to hide the latency of adding):
+
+AVX2_KERNEL static void AddF64AVX2(const double *x, const double *y, double *r, long n)
+{
+    long i = 0;
+
+    for ( ; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+
+    AddF64(x + i, y + i, r + i, n - i);
+}
+
+AVX2_KERNEL static void MultiplyF64AVX2(const double *x, const double *y, double *r, long n)
+{
+    long i = 0;
+
+    for ( ; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+
+    MultiplyF64(x + i, y + i, r + i, n - i);
+}
+
+AVX2_KERNEL static double SumLanesAVX2(__m256d sum)
+{
+    double lanes[4];
+
+    _mm256_storeu_pd(lanes, sum);
+
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+AVX2_KERNEL static double DotF64AVX2(const double *x, const double *y, long n)
+{
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+    long i = 0;
+
+    for ( ; i + 8 <= n; i += 8) {
+        sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+
+    for ( ; i + 4 <= n; i += 4)
+      sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+
+    return SumLanesAVX2(_mm256_add_pd(sum0, sum1)) + DotF64(x + i, y + i, n - i);
+}
+
+AVX2_KERNEL static double SumF64AVX2(const double *x, long n)
+{
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+    long i = 0;
+
+    for ( ; i + 8 <= n; i += 8) {
+        sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(x + i));
+        sum1 = _mm256_add_pd(sum1, _mm256_loadu_pd(x + i + 4));
+    }
+
+    for ( ; i + 4 <= n; i += 4)
+      sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(x + i));
+
+    return SumLanesAVX2(_mm256_add_pd(sum0, sum1)) + SumF64(x + i, n - i);
+}
+
+AVX2_KERNEL static double MinF64AVX2(const double *x, long n)
+{
+    double lanes[4];
+    long i = 4;
+
+    if (n < 4)
+      return MinF64(x, n);
+
+    __m256d min = _mm256_loadu_pd(x);
+    for ( ; i + 4 <= n; i += 4)
+      min = _mm256_min_pd(_mm256_loadu_pd(x + i), min);
+
+    _mm256_storeu_pd(lanes, min);
+    double result = MinF64(lanes, 4);
+
+    for ( ; i < n; i++)
+      result = (x[i] < result) ? x[i] : result;
+
+    return result;
+}
+
+AVX2_KERNEL static double MaxF64AVX2(const double *x, long n)
+{
+    double lanes[4];
+    long i = 4;
+
+    if (n < 4)
+      return MaxF64(x, n);
+
+    __m256d max = _mm256_loadu_pd(x);
+    for ( ; i + 4 <= n; i += 4)
+      max = _mm256_max_pd(_mm256_loadu_pd(x + i), max);
+
+    _mm256_storeu_pd(lanes, max);
+    double result = MaxF64(lanes, 4);
+
+    for ( ; i < n; i++)
+      result = (x[i] > result) ? x[i] : result;
+
+    return result;
+}
+
+AVX2_KERNEL static void AddI64AVX2(const PsilInteger *x, const PsilInteger *y, PsilInteger *r, long n)
+{
+    long i = 0;
+
+    for ( ; i + 4 <= n; i += 4)
+      _mm256_storeu_si256((__m256i *) (r + i), _mm256_add_epi64(_mm256_loadu_si256((const __m256i *) (x + i)),
+                                                                 _mm256_loadu_si256((const __m256i *) (y + i))));
+
+    AddI64(x + i, y + i, r + i, n - i);
+}
+
+AVX2_KERNEL static PsilInteger SumI64AVX2(const PsilInteger *x, long n)
+{
+    __m256i sum = _mm256_setzero_si256();
+    PsilInteger lanes[4];
+    long i = 0;
+
+    for ( ; i + 4 <= n; i += 4)
+      sum = _mm256_add_epi64(sum, _mm256_loadu_si256((const __m256i *) (x + i)));
+
+    _mm256_storeu_si256((__m256i *) lanes, sum);
+
+    return (PsilInteger) (SumI64(lanes, 4) + (uint64_t) SumI64(x + i, n - i));
+}
+
+AVX2_KERNEL static PsilInteger MinI64AVX2(const PsilInteger *x, long n)
+{
+    PsilInteger lanes[4];
+    long i = 4;
+
+    if (n < 4)
+      return MinI64(x, n);
+
+    __m256i min = _mm256_loadu_si256((const __m256i *) x);
+    for ( ; i + 4 <= n; i += 4) {
+        __m256i next = _mm256_loadu_si256((const __m256i *) (x + i));
+        min = _mm256_blendv_epi8(min, next, _mm256_cmpgt_epi64(min, next));
+    }
+
+    _mm256_storeu_si256((__m256i *) lanes, min);
+    PsilInteger result = MinI64(lanes, 4);
+
+    for ( ; i < n; i++)
+      result = (x[i] < result) ? x[i] : result;
+
+    return result;
+}
+
+AVX2_KERNEL static PsilInteger MaxI64AVX2(const PsilInteger *x, long n)
+{
+    PsilInteger lanes[4];
+    long i = 4;
+
+    if (n < 4)
+      return MaxI64(x, n);
+
+    __m256i max = _mm256_loadu_si256((const __m256i *) x);
+    for ( ; i + 4 <= n; i += 4) {
+        __m256i next = _mm256_loadu_si256((const __m256i *) (x + i));
+        max = _mm256_blendv_epi8(max, next, _mm256_cmpgt_epi64(next, max));
+    }
+
+    _mm256_storeu_si256((__m256i *) lanes, max);
+    PsilInteger result = MaxI64(lanes, 4);
+
+    for ( ; i < n; i++)
+      result = (x[i] > result) ? x[i] : result;
+
+    return result;
+}
+
+static const ArrayKernels AVX2Kernels = {
+    "avx2", AddF64AVX2, MultiplyF64AVX2, DotF64AVX2, SumF64AVX2, MinF64AVX2, MaxF64AVX2,
+    AddI64AVX2, SumI64AVX2, MinI64AVX2, MaxI64AVX2
+};
+
+#endif // SIMD_KERNELS
+
+// Returns the best kernels the processor supports.
+static const ArrayKernels *Kernels(void)
+{
+    static const ArrayKernels *kernels = NULL;
+
+    if (!kernels) {
+        kernels = &ScalarKernels;
+#if SIMD_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+          kernels = &AVX2Kernels;
+        else if (__builtin_cpu_supports("sse2"))
+          kernels = &SSE2Kernels;
+#endif // SIMD_KERNELS
+    }
+
+    return kernels;
+}
+
+// Returns the name of the kernels in use.
+const char *ArrayKernelsName(void)
+{
+    return Kernels()->name;
+}
+
+// Returns a new array of zeros.
+static Form *NewArray(PsilElementType elementType, long length)
+{
+    // (Both element types are 8 bytes.)
+    void *data = calloc(length ? length : 1, sizeof(double));
+    Form *form;
+
+    if (!data)
+      return ErrorForm("MakeArray():  Failed to allocate %ld elements!\n", length);
+
+    if ((form = AllocateForm(kPsilArray)) == NULL) {
+        free(data);
+        return ErrorForm("MakeArray():  AllocateForm() failed!\n");
+    }
+
+    form->value.array.data = data;
+    form->value.array.length = length;
+    form->value.array.elementType = elementType;
+    AddExternalBytes(length * sizeof(double));
+
+    return form;
+}
+
+// Returns a new array of the length, with element type "F64" or "I64".
+Form *MakeArray(Form *type, Form *length)
+{
+    PsilElementType elementType;
+
+    if (EqStr(type, "F64"))
+      elementType = kPsilF64;
+    else if (EqStr(type, "I64"))
+      elementType = kPsilI64;
+    else
+      return ErrorForm("MakeArray():  Unknown element type (expected F64 or I64)!\n");
+
+    if (!IsInteger(length) || (IntegerValue(length) < 0))
+      return ErrorForm("MakeArray():  Length must be a non-negative integer!\n");
+
+    return NewArray(elementType, (long) IntegerValue(length));
+}
+
+// Returns the element index, after checking that it is in bounds.
+static long CheckIndex(const char *name, PsilArray *array, Form *index)
+{
+    if (!IsInteger(index) || (IntegerValue(index) < 0) || (IntegerValue(index) >= array->length)) {
+        ErrorForm("%s():  Index out of bounds (length %ld)!\n", name, array->length);
+        return 0;
+    }
+
+    return (long) IntegerValue(index);
+}
+
+Form *ArrayRef(Form *array, Form *index)
+{
+    if (!IsArray(array))
+      return ErrorForm("ArrayRef():  Non-array argument!\n");
+
+    PsilArray *parray = ArrayValue(array);
+    long i = CheckIndex("ArrayRef", parray, index);
+
+    if (parray->elementType == kPsilF64)
+      return MakeFlonum(((double *) parray->data)[i]);
+    else
+      return MakeInteger(((PsilInteger *) parray->data)[i]);
+}
+
+Form *ArraySet(Form *array, Form *index, Form *value)
+{
+    if (!IsArray(array))
+      return ErrorForm("ArraySet():  Non-array argument!\n");
+
+    PsilArray *parray = ArrayValue(array);
+    long i = CheckIndex("ArraySet", parray, index);
+
+    if (parray->elementType == kPsilF64) {
+        if (!IsNumber(value))
+          return ErrorForm("ArraySet():  Non-numeric value for F64 array!\n");
+        ((double *) parray->data)[i] = NumberValue(value);
+    } else {
+        if (!IsInteger(value))
+          return ErrorForm("ArraySet():  Non-integer value for I64 array!\n");
+        ((PsilInteger *) parray->data)[i] = IntegerValue(value);
+    }
+
+    return value;
+}
+
+Form *ArrayLength(Form *array)
+{
+    if (!IsArray(array))
+      return ErrorForm("ArrayLength():  Non-array argument!\n");
+
+    return MakeInteger(ArrayValue(array)->length);
+}
+
+// Check that the arguments are arrays of the same type and length.
+static void CheckArrays(const char *name, Form *x, Form *y)
+{
+    if (!IsArray(x) || !IsArray(y))
+      ErrorForm("%s():  Non-array argument(s)!\n", name);
+    else if (ArrayValue(x)->elementType != ArrayValue(y)->elementType)
+      ErrorForm("%s():  Arrays have different element types!\n", name);
+    else if (ArrayValue(x)->length != ArrayValue(y)->length)
+      ErrorForm("%s():  Arrays have different lengths: %ld and %ld!\n", name,
+                ArrayValue(x)->length, ArrayValue(y)->length);
+}
+
+Form *ArrayAdd(Form *x, Form *y)
+{
+    CheckArrays("ArrayAdd", x, y);
+
+    PsilArray *px = ArrayValue(x), *py = ArrayValue(y);
+    Form *result = NewArray(px->elementType, px->length);
+
+    if (px->elementType == kPsilF64)
+      Kernels()->addF64((double *) px->data, (double *) py->data, (double *) ArrayValue(result)->data, px->length);
+    else
+      Kernels()->addI64((PsilInteger *) px->data, (PsilInteger *) py->data,
+                        (PsilInteger *) ArrayValue(result)->data, px->length);
+
+    return result;
+}
+
+Form *ArrayMultiply(Form *x, Form *y)
+{
+    CheckArrays("ArrayMultiply", x, y);
+
+    PsilArray *px = ArrayValue(x), *py = ArrayValue(y);
+    Form *result = NewArray(px->elementType, px->length);
+
+    if (px->elementType == kPsilF64)
+      Kernels()->multiplyF64((double *) px->data, (double *) py->data, (double *) ArrayValue(result)->data, px->length);
+    else
+      MultiplyI64((PsilInteger *) px->data, (PsilInteger *) py->data,
+                  (PsilInteger *) ArrayValue(result)->data, px->length);
+
+    return result;
+}
+
+Form *ArrayDot(Form *x, Form *y)
+{
+    CheckArrays("ArrayDot", x, y);
+
+    PsilArray *px = ArrayValue(x), *py = ArrayValue(y);
+
+    if (px->elementType == kPsilF64)
+      return MakeFlonum(Kernels()->dotF64((double *) px->data, (double *) py->data, px->length));
+    else
+      return MakeInteger(DotI64((PsilInteger *) px->data, (PsilInteger *) py->data, px->length));
+}
+
+Form *ArraySum(Form *x)
+{
+    if (!IsArray(x))
+      return ErrorForm("ArraySum():  Non-array argument!\n");
+
+    PsilArray *px = ArrayValue(x);
+
+    if (px->elementType == kPsilF64)
+      return MakeFlonum(Kernels()->sumF64((double *) px->data, px->length));
+    else
+      return MakeInteger(Kernels()->sumI64((PsilInteger *) px->data, px->length));
+}
+
+// Returns the minimum element if "max" is false, or else the maximum.
+static Form *ArrayExtreme(const char *name, Form *x, bool max)
+{
+    if (!IsArray(x))
+      return ErrorForm("%s():  Non-array argument!\n", name);
+
+    PsilArray *px = ArrayValue(x);
+
+    if (!px->length)
+      return ErrorForm("%s():  Empty array!\n", name);
+
+    if (px->elementType == kPsilF64) {
+        const double *data = (double *) px->data;
+        return MakeFlonum(max ? Kernels()->maxF64(data, px->length) : Kernels()->minF64(data, px->length));
+    } else {
+        const PsilInteger *data = (PsilInteger *) px->data;
+        return MakeInteger(max ? Kernels()->maxI64(data, px->length) : Kernels()->minI64(data, px->length));
+    }
+}
+
+Form *ArrayMin(Form *x)
+{
+    return ArrayExtreme("ArrayMin", x, false);
+}
+
+Form *ArrayMax(Form *x)
+{
+    return ArrayExtreme("ArrayMax", x, true);
+}
+
+// Returns a new F64 array of the function of each element.
+static Form *ArrayMap(const char *name, Form *x, double (*function)(double))
+{
+    if (!IsArray(x))
+      return ErrorForm("%s():  Non-array argument!\n", name);
+
+    PsilArray *px = ArrayValue(x);
+    Form *result = NewArray(kPsilF64, px->length);
+    double *r = (double *) ArrayValue(result)->data;
+
+    if (px->elementType == kPsilF64) {
+        const double *data = (double *) px->data;
+        for (long i = 0; i < px->length; i++)
+          r[i] = function(data[i]);
+    } else {
+        const PsilInteger *data = (PsilInteger *) px->data;
+        for (long i = 0; i < px->length; i++)
+          r[i] = function((double) data[i]);
+    }
+
+    return result;
+}
+
+Form *ArraySin(Form *x)
+{
+    return ArrayMap("ArraySin", x, sin);
+}
+
+Form *ArrayExp(Form *x)
+{
+    return ArrayMap("ArrayExp", x, exp);
+}
+
+Form *ArrayLn(Form *x)
+{
+    return ArrayMap("ArrayLn", x, log);
+}
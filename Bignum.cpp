@@ -0,0 +1,705 @@
+/*
+    File:   Bignum.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 19:41:06 2026
+
+    Description:
+       Psil bignum arithmetic.
+
+       Integers whose values do not fit in a "PsilInteger" are bignums,
+       whose magnitudes are arrays of base 2^32 digits, least significant
+       first.  The arithmetic primitives promote to bignums when exact
+       integer arithmetic overflows, and results which fit are always
+       demoted back to integers, so each value has only one representation.
+
+       Multiplication is schoolbook for small numbers, and Karatsuba's
+       divide-and-conquer algorithm (three half-size products instead of
+       four) above a threshold number of digits.  Division is Knuth's
+       Algorithm D.  Conversion to decimal splits the number by the square
+       of the power of 10 below it, and converts the quotient and remainder
+       recursively, so that most of the work is done by the few large
+       divisions rather than by repeatedly dividing the whole number by a
+       small power of 10.
+
+       These functions take their arguments as integers or bignums, and do
+       not evaluate anything, so they are not safe points.
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Psil.h"
+
+
+// Define constants.
+
+
+// The largest power of 10 which fits in a digit, and its number of decimal digits.
+static const uint32_t kDecimalBase = 1000000000;
+static const int      kDecimalBaseDigits = 9;
+
+// Convert numbers of at most this many digits to decimal by repeated division.
+static const long kDecimalSplitThreshold = 32;
+
+// Refuse to compute powers with more than this many bits.
+static const double kMaxExptBits = 256.0 * 1024 * 1024;
+
+
+// Define types.
+
+
+// A bignum or integer operand, or a result being built.
+// (An integer's digits are held in "small", so these must not be copied.)
+typedef struct BigInteger {
+    uint32_t *digits;
+    long      length;
+    int       sign;
+    uint32_t  small[2];
+} BigInteger;
+
+
+// Define global variables.
+
+
+// Multiply by Karatsuba's algorithm when both numbers have at least this many digits.
+long KaratsubaThreshold = 48;
+
+
+// Define functions.
+
+
+static uint32_t *AllocateDigits(long length)
+{
+    // (Allocate at least one digit, so that empty results are valid.)
+    uint32_t *digits = (uint32_t *) malloc((length ? length : 1) * sizeof(uint32_t));
+
+    if (!digits)
+      ErrorOut("AllocateDigits():  Failed to allocate %ld digits!\n", length);
+
+    return digits;
+}
+
+// Returns the length of the digits without leading zeros.
+static long Trim(const uint32_t *digits, long length)
+{
+    while (length && !digits[length - 1])
+      length--;
+
+    return length;
+}
+
+// Returns -1, 0 or 1 as the magnitude a is less than, equal to or greater than b.
+static int CompareMagnitudes(const uint32_t *a, long na, const uint32_t *b, long nb)
+{
+    if (na != nb)
+      return (na < nb) ? -1 : 1;
+
+    while (na--)
+      if (a[na] != b[na])
+        return (a[na] < b[na]) ? -1 : 1;
+
+    return 0;
+}
+
+// r = a + b, where na >= nb, and r has na + 1 digits.
+static void AddMagnitudes(const uint32_t *a, long na, const uint32_t *b, long nb, uint32_t *r)
+{
+    uint64_t carry = 0;
+    long index;
+
+    for (index = 0; index < nb; index++) {
+        carry += (uint64_t) a[index] + b[index];
+        r[index] = (uint32_t) carry;
+        carry >>= 32;
+    }
+
+    for ( ; index < na; index++) {
+        carry += a[index];
+        r[index] = (uint32_t) carry;
+        carry >>= 32;
+    }
+
+    r[na] = (uint32_t) carry;
+}
+
+// r = a - b, where a >= b, and r has na digits.
+static void SubtractMagnitudes(const uint32_t *a, long na, const uint32_t *b, long nb, uint32_t *r)
+{
+    int64_t borrow = 0;
+    long index;
+
+    for (index = 0; index < nb; index++) {
+        int64_t difference = (int64_t) a[index] - b[index] - borrow;
+        r[index] = (uint32_t) difference;
+        borrow = (difference < 0);
+    }
+
+    for ( ; index < na; index++) {
+        int64_t difference = (int64_t) a[index] - borrow;
+        r[index] = (uint32_t) difference;
+        borrow = (difference < 0);
+    }
+}
+
+// r += a, where the sum fits in the nr digits of r.
+static void AddInto(uint32_t *r, long nr, const uint32_t *a, long na)
+{
+    uint64_t carry = 0;
+    long index;
+
+    for (index = 0; index < na; index++) {
+        carry += (uint64_t) r[index] + a[index];
+        r[index] = (uint32_t) carry;
+        carry >>= 32;
+    }
+
+    for ( ; carry && (index < nr); index++) {
+        carry += r[index];
+        r[index] = (uint32_t) carry;
+        carry >>= 32;
+    }
+}
+
+// r -= a, where r >= a.
+static void SubtractFrom(uint32_t *r, long nr, const uint32_t *a, long na)
+{
+    int64_t borrow = 0;
+    long index;
+
+    for (index = 0; index < na; index++) {
+        int64_t difference = (int64_t) r[index] - a[index] - borrow;
+        r[index] = (uint32_t) difference;
+        borrow = (difference < 0);
+    }
+
+    for ( ; borrow && (index < nr); index++) {
+        int64_t difference = (int64_t) r[index] - borrow;
+        r[index] = (uint32_t) difference;
+        borrow = (difference < 0);
+    }
+}
+
+// r = a * b, where r has na + nb digits.
+static void MultiplySchoolbook(const uint32_t *a, long na, const uint32_t *b, long nb, uint32_t *r)
+{
+    memset(r, 0, (na + nb) * sizeof(uint32_t));
+
+    for (long i = 0; i < na; i++) {
+        uint64_t digit = a[i], carry = 0;
+        if (!digit)
+          continue;
+        for (long j = 0; j < nb; j++) {
+            carry += digit * b[j] + r[i + j];
+            r[i + j] = (uint32_t) carry;
+            carry >>= 32;
+        }
+        r[i + nb] = (uint32_t) carry;
+    }
+}
+
+// r = a * b, where r has na + nb digits.
+// (With a = a1 B^m + a0 and b = b1 B^m + b0, a * b = z2 B^2m + z1 B^m + z0, where
+//  z2 = a1 b1, z0 = a0 b0, and z1 = (a0 + a1)(b0 + b1) - z2 - z0.)
+static void MultiplyMagnitudes(const uint32_t *a, long na, const uint32_t *b, long nb, uint32_t *r)
+{
+    if (na < nb) {
+        const uint32_t *t = a; a = b; b = t;
+        long n = na; na = nb; nb = n;
+    }
+
+    if (nb < KaratsubaThreshold) {
+        MultiplySchoolbook(a, na, b, nb, r);
+        return;
+    }
+
+    // Multiply a much longer number by the shorter one a piece at a time.
+    if (na >= 2 * nb) {
+        uint32_t *product = AllocateDigits(2 * nb);
+        memset(r, 0, (na + nb) * sizeof(uint32_t));
+        for (long offset = 0; offset < na; offset += nb) {
+            long n = (na - offset < nb) ? (na - offset) : nb;
+            MultiplyMagnitudes(a + offset, n, b, nb, product);
+            AddInto(r + offset, na + nb - offset, product, n + nb);
+        }
+        free((void *) product);
+        return;
+    }
+
+    // (Since nb > na / 2, both numbers have high halves.)
+    long m = na / 2, na1 = na - m, nb1 = nb - m;
+    long nsa = na1 + 1, nsb = ((nb1 > m) ? nb1 : m) + 1;
+    uint32_t *sa = AllocateDigits(nsa), *sb = AllocateDigits(nsb);
+    uint32_t *z1 = AllocateDigits(nsa + nsb);
+
+    AddMagnitudes(a + m, na1, a, m, sa);
+    if (nb1 >= m)
+      AddMagnitudes(b + m, nb1, b, m, sb);
+    else
+      AddMagnitudes(b, m, b + m, nb1, sb);
+    nsa = Trim(sa, nsa);
+    nsb = Trim(sb, nsb);
+    MultiplyMagnitudes(sa, nsa, sb, nsb, z1);
+    long nz1 = nsa + nsb;
+
+    // (z0 and z2 are computed directly into the low and high parts of the result.)
+    MultiplyMagnitudes(a, m, b, m, r);
+    MultiplyMagnitudes(a + m, na1, b + m, nb1, r + 2 * m);
+    SubtractFrom(z1, nz1, r, 2 * m);
+    SubtractFrom(z1, nz1, r + 2 * m, na1 + nb1);
+    AddInto(r + m, na + nb - m, z1, Trim(z1, nz1));
+
+    free((void *) sa);
+    free((void *) sb);
+    free((void *) z1);
+}
+
+// q = a / d, returning the remainder, where q has na digits.
+static uint32_t DivideSmall(const uint32_t *a, long na, uint32_t d, uint32_t *q)
+{
+    uint64_t remainder = 0;
+
+    while (na--) {
+        uint64_t dividend = (remainder << 32) | a[na];
+        q[na] = (uint32_t) (dividend / d);
+        remainder = dividend % d;
+    }
+
+    return (uint32_t) remainder;
+}
+
+static int LeadingZeros(uint32_t digit)
+{
+    int count = 0;
+
+    for ( ; !(digit & 0x80000000U); digit <<= 1)
+      count++;
+
+    return count;
+}
+
+// q = a / b and r = a % b, where na >= nb, b has no leading zeros,
+//  q has na - nb + 1 digits, and r has nb digits.
+// (This is Knuth's Algorithm D, from TAOCP volume 2, section 4.3.1.)
+static void DivideMagnitudes(const uint32_t *a, long na, const uint32_t *b, long nb, uint32_t *q, uint32_t *r)
+{
+    if (nb == 1) {
+        r[0] = DivideSmall(a, na, b[0], q);
+        return;
+    }
+
+    // Normalize, so that the divisor's top digit has its high bit set.
+    int shift = LeadingZeros(b[nb - 1]);
+    uint32_t *u = AllocateDigits(na + 1), *v = AllocateDigits(nb);
+    long i, j;
+
+    for (i = nb - 1; i > 0; i--)
+      v[i] = shift ? ((b[i] << shift) | (b[i - 1] >> (32 - shift))) : b[i];
+    v[0] = b[0] << shift;
+    u[na] = shift ? (a[na - 1] >> (32 - shift)) : 0;
+    for (i = na - 1; i > 0; i--)
+      u[i] = shift ? ((a[i] << shift) | (a[i - 1] >> (32 - shift))) : a[i];
+    u[0] = a[0] << shift;
+
+    for (j = na - nb; j >= 0; j--) {
+        // Estimate the quotient digit from the top two digits of the dividend.
+        uint64_t dividend = ((uint64_t) u[j + nb] << 32) | u[j + nb - 1];
+        uint64_t qhat = dividend / v[nb - 1], rhat = dividend % v[nb - 1];
+        while ((qhat >> 32) || (qhat * v[nb - 2] > ((rhat << 32) | u[j + nb - 2]))) {
+            qhat--;
+            if ((rhat += v[nb - 1]) >> 32)
+              break;
+        }
+
+        // Multiply and subtract.
+        uint64_t carry = 0;
+        int64_t borrow = 0, difference;
+        for (i = 0; i < nb; i++) {
+            uint64_t product = qhat * v[i] + carry;
+            carry = product >> 32;
+            difference = (int64_t) u[i + j] - (uint32_t) product - borrow;
+            u[i + j] = (uint32_t) difference;
+            borrow = (difference < 0);
+        }
+        difference = (int64_t) u[j + nb] - (int64_t) carry - borrow;
+        u[j + nb] = (uint32_t) difference;
+
+        // The estimate was one too large (rarely), so add back.
+        if (difference < 0) {
+            qhat--;
+            carry = 0;
+            for (i = 0; i < nb; i++) {
+                carry += (uint64_t) u[i + j] + v[i];
+                u[i + j] = (uint32_t) carry;
+                carry >>= 32;
+            }
+            u[j + nb] += (uint32_t) carry;
+        }
+
+        q[j] = (uint32_t) qhat;
+    }
+
+    // Unnormalize the remainder.
+    for (i = 0; i < nb - 1; i++)
+      r[i] = shift ? ((u[i] >> shift) | (u[i + 1] << (32 - shift))) : u[i];
+    r[nb - 1] = u[nb - 1] >> shift;
+
+    free((void *) u);
+    free((void *) v);
+}
+
+// Load an integer or bignum form.
+static void Load(Form *form, BigInteger *n)
+{
+    if (!IsInteger(form)) {
+        n->digits = form->value.bignum.digits;
+        n->length = form->value.bignum.length;
+        n->sign = form->value.bignum.sign;
+        return;
+    }
+
+    PsilInteger value = IntegerValue(form);
+    // (Negating in unsigned arithmetic is defined for the most negative integer.)
+    uint64_t magnitude = (value < 0) ? (0 - (uint64_t) value) : (uint64_t) value;
+
+    n->small[0] = (uint32_t) magnitude;
+    n->small[1] = (uint32_t) (magnitude >> 32);
+    n->digits = n->small;
+    n->length = Trim(n->small, 2);
+    n->sign = (value < 0) ? -1 : (value > 0);
+}
+
+// Returns the form for the (malloc()'d) digits, which it takes ownership of.
+// (Values which fit are demoted to integers.)
+static Form *MakeBignum(uint32_t *digits, long length, int sign)
+{
+    Form *form;
+
+    length = Trim(digits, length);
+
+    if (length <= 2) {
+        uint64_t magnitude = length ? digits[0] : 0;
+        if (length == 2)
+          magnitude |= (uint64_t) digits[1] << 32;
+        if ((sign > 0) ? (magnitude <= (uint64_t) INT64_MAX) : (magnitude <= (uint64_t) INT64_MAX + 1)) {
+            free((void *) digits);
+            return MakeInteger((sign > 0) ? (PsilInteger) magnitude : (PsilInteger) (0 - magnitude));
+        }
+    }
+
+    if ((form = AllocateForm(kPsilBignum)) == NULL) {
+        free((void *) digits);
+        return ErrorForm("MakeBignum():  AllocateForm() failed!\n");
+    }
+
+    form->value.bignum.digits = digits;
+    form->value.bignum.length = length;
+    form->value.bignum.sign = sign;
+    AddExternalBytes(length * sizeof(uint32_t));
+
+    return form;
+}
+
+// Returns the sum of x and y, negated if "negate" is set.
+static Form *AddSigned(Form *x, Form *y, bool negate)
+{
+    BigInteger a, b;
+
+    Load(x, &a);
+    Load(y, &b);
+    if (negate)
+      b.sign = -b.sign;
+
+    if (!b.sign)
+      return x;
+
+    long length = ((a.length > b.length) ? a.length : b.length) + 1;
+    uint32_t *digits = AllocateDigits(length);
+
+    if (!a.sign || (a.sign == b.sign)) {
+        if (a.length >= b.length)
+          AddMagnitudes(a.digits, a.length, b.digits, b.length, digits);
+        else
+          AddMagnitudes(b.digits, b.length, a.digits, a.length, digits);
+        return MakeBignum(digits, length, b.sign);
+    } else if (CompareMagnitudes(a.digits, a.length, b.digits, b.length) >= 0) {
+        SubtractMagnitudes(a.digits, a.length, b.digits, b.length, digits);
+        return MakeBignum(digits, a.length, a.sign);
+    } else {
+        SubtractMagnitudes(b.digits, b.length, a.digits, a.length, digits);
+        return MakeBignum(digits, b.length, b.sign);
+    }
+}
+
+Form *BignumAdd(Form *x, Form *y)
+{
+    return AddSigned(x, y, false);
+}
+
+Form *BignumSubtract(Form *x, Form *y)
+{
+    return AddSigned(x, y, true);
+}
+
+Form *BignumMultiply(Form *x, Form *y)
+{
+    BigInteger a, b;
+
+    Load(x, &a);
+    Load(y, &b);
+
+    if (!a.sign || !b.sign)
+      return MakeInteger(0);
+
+    uint32_t *digits = AllocateDigits(a.length + b.length);
+
+    MultiplyMagnitudes(a.digits, a.length, b.digits, b.length, digits);
+
+    return MakeBignum(digits, a.length + b.length, a.sign * b.sign);
+}
+
+// Returns the quotient of x and y (which must not be zero), truncated toward zero,
+//  and the remainder, which has the sign of x.
+Form *BignumDivide(Form *x, Form *y, Form **remainder)
+{
+    BigInteger a, b;
+
+    Load(x, &a);
+    Load(y, &b);
+
+    if (CompareMagnitudes(a.digits, a.length, b.digits, b.length) < 0) {
+        *remainder = x;
+        return MakeInteger(0);
+    }
+
+    uint32_t *q = AllocateDigits(a.length - b.length + 1), *r = AllocateDigits(b.length);
+
+    DivideMagnitudes(a.digits, a.length, b.digits, b.length, q, r);
+
+    *remainder = MakeBignum(r, b.length, a.sign);
+
+    return MakeBignum(q, a.length - b.length + 1, a.sign * b.sign);
+}
+
+// Returns -1, 0 or 1 as x is less than, equal to or greater than y.
+int BignumCompare(Form *x, Form *y)
+{
+    BigInteger a, b;
+
+    Load(x, &a);
+    Load(y, &b);
+
+    if (a.sign != b.sign)
+      return (a.sign < b.sign) ? -1 : 1;
+
+    return a.sign * CompareMagnitudes(a.digits, a.length, b.digits, b.length);
+}
+
+double BignumToDouble(Form *x)
+{
+    BigInteger a;
+    double value = 0.0;
+
+    Load(x, &a);
+
+    // (Only the top three digits can affect a double.)
+    for (long index = a.length - 1; (index >= 0) && (index >= a.length - 3); index--)
+      value = ldexp(value, 32) + a.digits[index];
+
+    return a.sign * ldexp(value, 32 * ((a.length > 3) ? (a.length - 3) : 0));
+}
+
+// Returns the integer or bignum equal to the (finite, integral) double.
+// (Taking the digits by fmod() and dividing by 2^32 are both exact.)
+Form *DoubleToBignum(double number)
+{
+    double magnitude = fabs(number);
+    int exponent;
+
+    frexp(magnitude, &exponent);
+
+    long length = (exponent > 0) ? ((exponent + 31) / 32) : 1;
+    uint32_t *digits = AllocateDigits(length);
+
+    for (long index = 0; index < length; index++) {
+        digits[index] = (uint32_t) fmod(magnitude, 4294967296.0);
+        magnitude = floor(magnitude / 4294967296.0);
+    }
+
+    return MakeBignum(digits, length, (number < 0) ? -1 : 1);
+}
+
+// Returns x raised to the non-negative power, by repeated squaring.
+Form *BignumExpt(Form *x, PsilInteger power)
+{
+    BigInteger a;
+
+    Load(x, &a);
+
+    if ((a.length > 1) || (a.digits[0] > 1)) {
+        double bits = (double) power * (32 * a.length - LeadingZeros(a.digits[a.length - 1]));
+        if (bits > kMaxExptBits)
+          return ErrorForm("BignumExpt():  Result too large: %.0f bits!\n", bits);
+    }
+
+    uint32_t *result = AllocateDigits(1), *base = AllocateDigits(a.length);
+    long resultLength = 1, baseLength = a.length;
+    int sign = ((a.sign < 0) && (power & 1)) ? -1 : 1;
+
+    result[0] = 1;
+    memcpy(base, a.digits, a.length * sizeof(uint32_t));
+
+    while (power) {
+        if (power & 1) {
+            uint32_t *product = AllocateDigits(resultLength + baseLength);
+            MultiplyMagnitudes(result, resultLength, base, baseLength, product);
+            free((void *) result);
+            result = product;
+            resultLength = Trim(product, resultLength + baseLength);
+        }
+        if (power >>= 1) {
+            uint32_t *square = AllocateDigits(2 * baseLength);
+            MultiplyMagnitudes(base, baseLength, base, baseLength, square);
+            free((void *) base);
+            base = square;
+            baseLength = Trim(square, 2 * baseLength);
+        }
+    }
+
+    free((void *) base);
+
+    return MakeBignum(result, resultLength, sign);
+}
+
+// Returns the bignum (or integer) for the token, which must be an optionally
+//  signed string of decimal digits, optionally followed by a decimal point.
+Form *ReadBignum(const char *token)
+{
+    int sign = (*token == '-') ? -1 : 1;
+
+    if ((*token == '-') || (*token == '+'))
+      token++;
+
+    long numDigits = strspn(token, "0123456789");
+    // (Each digit needs at most 4 bits.)
+    long length = (numDigits * 4) / 32 + 2, used = 0;
+    uint32_t *digits = AllocateDigits(length);
+
+    // Multiply in the decimal digits a digit's worth at a time.
+    for (long index = 0; index < numDigits; ) {
+        uint32_t chunk = 0, scale = 1;
+        for (int count = 0; (count < kDecimalBaseDigits) && (index < numDigits); count++, index++) {
+            chunk = chunk * 10 + (token[index] - '0');
+            scale *= 10;
+        }
+        uint64_t carry = chunk;
+        for (long i = 0; i < used; i++) {
+            carry += (uint64_t) digits[i] * scale;
+            digits[i] = (uint32_t) carry;
+            carry >>= 32;
+        }
+        if (carry)
+          digits[used++] = (uint32_t) carry;
+    }
+
+    return MakeBignum(digits, used, sign);
+}
+
+// Write the decimal digits of the magnitude, padded with leading zeros to "width"
+//  characters (if non-zero), into the buffer, returning the number written.
+static long WriteDecimal(const uint32_t *a, long na, long width, uint32_t **powers, long *powerLengths,
+                         int numPowers, char *buffer)
+{
+    na = Trim(a, na);
+
+    int level = numPowers - 1;
+    // Split by the largest power whose square might not be less than the number.
+    while ((level >= 0) && (2 * powerLengths[level] > na + 1))
+      level--;
+
+    if ((na <= kDecimalSplitThreshold) || (level < 0)) {
+        // Repeatedly divide by the largest power of 10 fitting in a digit.
+        uint32_t *q = AllocateDigits(na), *chunks = AllocateDigits(na * 2 + 1);
+        long numChunks = 0, count = 0;
+        if (na)
+          memcpy(q, a, na * sizeof(uint32_t));
+        while (na) {
+            chunks[numChunks++] = DivideSmall(q, na, kDecimalBase, q);
+            na = Trim(q, na);
+        }
+        char top[16];
+        int topLength = numChunks ? sprintf(top, "%u", chunks[numChunks - 1]) : 0;
+        long numDigits = numChunks ? (numChunks - 1) * kDecimalBaseDigits + topLength : (width ? 0 : 1);
+        for ( ; count < width - numDigits; count++)
+          buffer[count] = '0';
+        if (!numChunks && !width)
+          buffer[count++] = '0';
+        if (numChunks) {
+            memcpy(buffer + count, top, topLength);
+            count += topLength;
+        }
+        for (long index = numChunks - 2; index >= 0; index--)
+          count += sprintf(buffer + count, "%09u", chunks[index]);
+        free((void *) q);
+        free((void *) chunks);
+        return count;
+    }
+
+    // The high part is the quotient, and the low part the remainder, padded to the power's width.
+    long lowWidth = (long) kDecimalBaseDigits << level, nq = na - powerLengths[level] + 1;
+    uint32_t *q = AllocateDigits(nq), *r = AllocateDigits(powerLengths[level]);
+    long count;
+
+    DivideMagnitudes(a, na, powers[level], powerLengths[level], q, r);
+    count = WriteDecimal(q, nq, width ? width - lowWidth : 0, powers, powerLengths, numPowers, buffer);
+    count += WriteDecimal(r, powerLengths[level], lowWidth, powers, powerLengths, numPowers, buffer + count);
+
+    free((void *) q);
+    free((void *) r);
+
+    return count;
+}
+
+// Returns the (malloc()'d) decimal representation of the bignum.
+char *BignumToString(Form *x)
+{
+    BigInteger a;
+    uint32_t *powers[64];
+    long powerLengths[64];
+    int numPowers = 0;
+
+    Load(x, &a);
+
+    // Square 10^9 while the powers might be needed, i.e., up to about the square root of the number.
+    powers[0] = AllocateDigits(1);
+    powers[0][0] = kDecimalBase;
+    powerLengths[numPowers++] = 1;
+    while ((a.length > kDecimalSplitThreshold) && (4 * powerLengths[numPowers - 1] <= a.length + 2)) {
+        long length = 2 * powerLengths[numPowers - 1];
+        powers[numPowers] = AllocateDigits(length);
+        MultiplyMagnitudes(powers[numPowers - 1], powerLengths[numPowers - 1],
+                           powers[numPowers - 1], powerLengths[numPowers - 1], powers[numPowers]);
+        powerLengths[numPowers] = Trim(powers[numPowers], length);
+        numPowers++;
+    }
+
+    // (Each digit has fewer than 10 decimal digits.)
+    char *string = (char *) malloc(a.length * 10 + 3);
+    long count = 0;
+
+    if (!string)
+      ErrorOut("BignumToString():  Failed to allocate %ld characters!\n", a.length * 10 + 3);
+
+    if (a.sign < 0)
+      string[count++] = '-';
+    count += WriteDecimal(a.digits, a.length, 0, powers, powerLengths, numPowers, string + count);
+    string[count] = '\0';
+
+    while (numPowers)
+      free((void *) powers[--numPowers]);
+
+    return string;
+}
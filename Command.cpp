@@ -24,6 +24,7 @@
 
 bool CmdHelp(char *cmd_line);
 bool CmdEnv(char *cmd_line);
+bool CmdGC(char *cmd_line);
 
 
 // Define global variables.
@@ -33,6 +34,7 @@ static PsilCommand Commands[] =
 {
     {"HELP",   CmdHelp,   "Print help for Psil commands."},
     {"ENV",    CmdEnv,    "Print main Psil environments."},
+    {"GC",     CmdGC,     "Collect garbage and print heap statistics."},
     {NULL,     NULL,      NULL}
 };
 
@@ -56,14 +58,14 @@ bool DoCommand(char *cmd_line)
     return false;
 }
 
-char *ReadCommand(FILE *instream, char *cmd_line)
+char *ReadCommand(PsilInput *input, char *cmd_line)
 {
     char c;
     int index = 0;
 
     cmd_line[index] = '\0';
 
-    while (((c = fgetc(instream)) != EOF) && (index < kMaxTokenLen)
+    while (((c = InputChar(input)) != EOF) && (index < kMaxTokenLen)
            && (c != kReturn) && (c != kNewline))
       cmd_line[index++] = c;
     cmd_line[index] = '\0';
@@ -92,14 +94,56 @@ bool CmdHelp(char *cmd_line)
     return true;
 }
 
+static void PrintGlobal(Form **symbol)
+{
+    Form *value = SymbolValue(*symbol);
+
+    if (value) {
+        Message("  [\"%s\", ", SymbolName(*symbol));
+        Print(value, StandardOutput);
+        Message("]\n");
+    }
+}
+
 bool CmdEnv(char *cmd_line)
 {
     Message("Psil Environment:\n");
+    Message("Globals:\n");
+    VisitSymbols(PrintGlobal);
     Message("TopLevelEnv:\n");
     PrintEnvironment(TopLevelEnv, StandardOutput, true);
     Message("\n");
     Message("CurrentEnv:\n");
     PrintEnvironment(CurrentEnv, StandardOutput, true);
     Message("\n");
+
+    EnvironmentStatistics stats;
+    GetEnvironmentStatistics(&stats);
+    Message("Bindings:  %ld allocated; %ld reused; %ld released; %ld frames retained; %ld flushed; %ld pooled.\n",
+            stats.allocated, stats.reused, stats.released, stats.retained, stats.flushed, stats.pooled);
+    return true;
+}
+
+bool CmdGC(char *cmd_line)
+{
+    GCStatistics stats;
+
+    CollectGarbage();
+    GetGCStatistics(&stats);
+
+    Message("Psil Garbage Collection:\n");
+    Message("  Reclaimed %ld objects (%ld bytes) in %.3f ms.\n",
+            stats.lastObjectsReclaimed, stats.lastBytesReclaimed, stats.lastMilliseconds);
+    Message("  Old generation in use: %ld bytes; %ld pages of %ld bytes.\n",
+            stats.bytesInUse, stats.numPages, stats.pageSize);
+    if (stats.heapLimit)
+      Message("  Heap limit: %ld bytes.\n", stats.heapLimit);
+    else
+      Message("  Heap limit: None.\n");
+    Message("  Total: %ld minor collections promoted %ld bytes in %.3f ms.\n",
+            stats.minorCollections, stats.bytesPromoted, stats.minorMilliseconds);
+    Message("  Total: %ld full collections in %.3f ms; %ld bytes reclaimed overall.\n",
+            stats.collections, stats.totalMilliseconds, stats.totalBytesReclaimed);
+
     return true;
 }
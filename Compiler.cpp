@@ -0,0 +1,210 @@
+/*
+    File:   Compiler.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 16:20:45 2026
+
+    Description:
+       Psil bytecode compiler.
+
+       Compiles the (resolved) body of a lambda form into instructions
+       for the virtual machine in "VM.cpp".  Since the resolver has already
+       replaced references to locals with their lexical addresses, any
+       remaining variable references are to globals.  Nested lambda forms
+       are compiled along with the body into code constants, from which
+       closures are made when they are evaluated.
+
+       Anything the compiler does not handle specially is compiled into
+       an instruction to interpret it (e.g., an unresolved lambda form.)
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include "Psil.h"
+
+
+// Define constants.
+
+
+// Initial sizes of the instruction and constant buffers.
+static const long kInitialOpsSize = 64;
+static const long kInitialConstantsSize = 16;
+
+
+// Define types.
+
+
+// The instructions and constants being compiled.
+typedef struct CodeBuffer {
+    long  *ops;
+    long   numOps;
+    long   opsSize;
+    Form **constants;
+    long   numConstants;
+    long   constantsSize;
+} CodeBuffer;
+
+
+// Define functions.
+
+
+static void Compile(CodeBuffer *buffer, Form *form, bool tail);
+
+static void Emit(CodeBuffer *buffer, long op)
+{
+    if (buffer->numOps >= buffer->opsSize) {
+        long size = buffer->opsSize ? 2 * buffer->opsSize : kInitialOpsSize;
+        long *ops = (long *) realloc(buffer->ops, size * sizeof(long));
+        if (!ops)
+          ErrorOut("Emit():  Failed to grow the instruction buffer to size %ld!\n", size);
+        buffer->ops = ops;
+        buffer->opsSize = size;
+    }
+
+    buffer->ops[buffer->numOps++] = op;
+}
+
+static void Emit(CodeBuffer *buffer, PsilOpcode opcode, long operand)
+{
+    Emit(buffer, (long) opcode);
+    Emit(buffer, operand);
+}
+
+// Returns the index of the constant, adding it if necessary.
+static long Constant(CodeBuffer *buffer, Form *form)
+{
+    for (long index = 0; index < buffer->numConstants; index++)
+      if (buffer->constants[index] == form)
+        return index;
+
+    if (buffer->numConstants >= buffer->constantsSize) {
+        long size = buffer->constantsSize ? 2 * buffer->constantsSize : kInitialConstantsSize;
+        Form **constants = (Form **) realloc(buffer->constants, size * sizeof(Form *));
+        if (!constants)
+          ErrorOut("Constant():  Failed to grow the constant buffer to size %ld!\n", size);
+        buffer->constants = constants;
+        buffer->constantsSize = size;
+    }
+
+    buffer->constants[buffer->numConstants] = form;
+
+    return buffer->numConstants++;
+}
+
+// Emit a jump, returning the location of its target to be patched.
+static long EmitJump(CodeBuffer *buffer, PsilOpcode opcode)
+{
+    Emit(buffer, opcode, 0);
+
+    return buffer->numOps - 1;
+}
+
+static void PatchJump(CodeBuffer *buffer, long target)
+{
+    buffer->ops[target] = buffer->numOps;
+}
+
+// Compile setting a variable to the value on the top of the stack.
+static void CompileSet(CodeBuffer *buffer, Form *variable)
+{
+    if (IsLocal(variable))
+      Emit(buffer, kOpSetLocal, Constant(buffer, variable));
+    else
+      Emit(buffer, kOpSetGlobal, Constant(buffer, variable));
+}
+
+// Compile a sequence of forms, leaving the value of the last one on the stack.
+static void CompileSequence(CodeBuffer *buffer, Form *body, bool tail)
+{
+    if (IsNull(body))
+      Emit(buffer, kOpConstant, Constant(buffer, SymbolNIL));
+
+    while (IsCons(body)) {
+        Compile(buffer, Car(body), (tail && IsNull(Cdr(body))));
+        body = Cdr(body);
+        if (!IsNull(body))
+          Emit(buffer, kOpPop);
+    }
+}
+
+// Compile a function call, unless the arguments are not a proper list.
+// (A call in tail position replaces the caller's frame with the callee's.)
+static bool CompileCall(CodeBuffer *buffer, Form *form, bool tail)
+{
+    Form *args = Cdr(form);
+    long nargs = 0;
+
+    for (Form *arg = args; !IsNull(arg); arg = Cdr(arg), nargs++)
+      if (!IsCons(arg))
+        return false;
+
+    Compile(buffer, Car(form), false);
+
+    for ( ; !IsNull(args); args = Cdr(args))
+      Compile(buffer, Car(args), false);
+
+    Emit(buffer, (tail ? kOpTailCall : kOpCall), nargs);
+
+    return true;
+}
+
+// Compile a form in the same way that "Eval()" would evaluate it.
+// (The branches of an "if" in tail position are also in tail position.)
+static void Compile(CodeBuffer *buffer, Form *form, bool tail)
+{
+    if (IsLocal(form))
+      Emit(buffer, kOpLocal, Constant(buffer, form));
+    else if (IsSymbol(form) && !IsNull(form))
+      Emit(buffer, kOpGlobal, Constant(buffer, form));
+    else if (IsCallSite(form))
+      // (The virtual machine reads the symbol's value cell directly, so it needs no cache.)
+      Emit(buffer, kOpGlobal, Constant(buffer, CallSiteValue(form)->symbol));
+    else if (!IsCons(form))
+      Emit(buffer, kOpConstant, Constant(buffer, form));
+    else if (IsQuote(Car(form)))
+      Emit(buffer, kOpConstant, Constant(buffer, Cadr(form)));
+    else if (IsIf(Car(form))) {
+        Compile(buffer, Cadr(form), false);
+        long elseJump = EmitJump(buffer, kOpJumpIfNil);
+        Compile(buffer, Caddr(form), tail);
+        long endJump = EmitJump(buffer, kOpJump);
+        PatchJump(buffer, elseJump);
+        Compile(buffer, Cadddr(form), tail);
+        PatchJump(buffer, endJump);
+    } else if (IsResolvedLambda(Car(form)))
+      Emit(buffer, kOpClosure, Constant(buffer, CompileBody(Cadr(form), Cddr(form))));
+    else if (IsAssignment(form)) {
+        Compile(buffer, Caddr(form), false);
+        CompileSet(buffer, Cadr(form));
+    } else if (IsDefinition(form)) {
+        // (Bind the variable first, as "Eval()" does, for recursive definitions.)
+        Emit(buffer, kOpConstant, Constant(buffer, SymbolNIL));
+        CompileSet(buffer, Cadr(form));
+        Emit(buffer, kOpPop);
+        Compile(buffer, Caddr(form), false);
+        CompileSet(buffer, Cadr(form));
+    } else if (IsLambda(Car(form)) || !CompileCall(buffer, form, tail))
+      Emit(buffer, kOpEval, Constant(buffer, form));
+}
+
+// Returns the code compiled from the resolved body of a lambda form.
+// (This does not evaluate anything, so it is not a safe point.)
+Form *CompileBody(Form *arglist, Form *body)
+{
+    CodeBuffer buffer = {NULL, 0, 0, NULL, 0, 0};
+
+    CompileSequence(&buffer, body, true);
+    Emit(&buffer, kOpReturn);
+
+    Form *code = MakeCode(arglist, body, buffer.ops, buffer.numOps, buffer.constants, buffer.numConstants);
+
+    if (TraceEvaluator) {
+        fprintf(StandardError, "\tCompileBody() ==> ");
+        Print(code, StandardError);
+        fprintf(StandardError, "\n");
+    }
+
+    return code;
+}
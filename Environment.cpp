@@ -18,14 +18,16 @@
 #include "Psil.h"
 
 
-// Define types.
+// Define macros.
 
 
-struct Environment {
-    const char  *name;
-    Form        *value;
-    Environment *parent;
-};
+// Define a primitive's entry point according to its number of arguments.
+// (Primitives of other than one or two arguments pop them from the stack.)
+#define PRIMITIVE0(name, func)          {name, 0, func, NULL, NULL, NULL}
+#define PRIMITIVE1(name, func)          {name, 1, NULL, func, NULL, NULL}
+#define PRIMITIVE2(name, func)          {name, 2, NULL, NULL, func, NULL}
+#define PRIMITIVEN(name, nargs, func)   {name, nargs, func, NULL, NULL, NULL}
+#define PRIMITIVEV(name, func)          {name, kVariadicArgs, NULL, NULL, NULL, func}
 
 
 // Define global variables.
@@ -33,61 +35,123 @@ struct Environment {
 
 static PsilFunc PrimitiveFuncs[] =
 {
-    {"CAR",        FuncCar,            1},
-    {"CDR",        FuncCdr,            1},
-    {"CONS",       FuncCons,           2},
-    {"ATOM",       FuncAtom,           1},
-    {"EQ",         FuncEq,             2},
-    {"NULL",       FuncNull,           1},
-    {"NOT",        FuncNull,           1},
-    {"SYMBOLP",    FuncSymbolp,        1},
-    {"LENGTH",     FuncLength,         1},
-    {"TYPE-OF",    FuncTypeOf,         1},
-    {"NUMBERP",    FuncNumberp,        1},
-    {"ZEROP",      FuncZerop,          1},
-    {"=",          FuncNumberEqual,    2},
-    {"<",          FuncLess,           2},
-    {"<=",         FuncLessEqual,      2},
-    {">",          FuncGreater,        2},
-    {">=",         FuncGreaterEqual,   2},
-    {"PLUS",       FuncPlus,           2},
-    {"+",          FuncPlus,           2},
-    {"MINUS",      FuncMinus,          2},
-    {"-",          FuncMinus,          2},
-    {"TIMES",      FuncTimes,          2},
-    {"*",          FuncTimes,          2},
-    {"DIVIDE",     FuncDivide,         2},
-    {"/",          FuncDivide,         2},
-    {"REMAINDER",  FuncRemainder,      2},
-    {"MOD",        FuncRemainder,      2},
-    {"%",          FuncRemainder,      2},
-    {"ADD1",       FuncAdd1,           1},
-    {"1+",         FuncAdd1,           1},
-    {"SUB1",       FuncSub1,           1},
-    {"1-",         FuncSub1,           1},
-    {"LN",         FuncLn,             1},
-    {"EXP",        FuncExp,            1},
-    {"LOG",        FuncLog,            2},
-    {"EXPT",       FuncExpt,           2},
-    {"SIN",        FuncSin,            1},
-    {"COS",        FuncCos,            1},
-    {"TAN",        FuncTan,            1},
-    {"EQUAL",      FuncEqual,          2},
-    {"SET",        FuncSet,            2},
-    {"TRACE",      FuncTrace,          1},
-    {"EXIT",       FuncExit,           0},
-    {"QUIT",       FuncExit,           0},
-    {"READ",       FuncRead,           0},
-    {"EVAL",       FuncEval,           1},
-    {"APPLY",      FuncApply,          2},
-    {"PRIN1",      FuncPrin1,          1},
-    {"PRINT",      FuncPrint,          1},
-    {NULL,         NULL,               0}
+    PRIMITIVE1("CAR",        FuncCar),
+    PRIMITIVE1("CDR",        FuncCdr),
+    PRIMITIVE2("CONS",       FuncCons),
+    PRIMITIVE2("RPLACA",     FuncRplaca),
+    PRIMITIVE2("RPLACD",     FuncRplacd),
+    PRIMITIVE1("ATOM",       FuncAtom),
+    PRIMITIVE2("EQ",         FuncEq),
+    PRIMITIVE1("NULL",       FuncNull),
+    PRIMITIVE1("NOT",        FuncNull),
+    PRIMITIVE1("SYMBOLP",    FuncSymbolp),
+    PRIMITIVE1("LENGTH",     FuncLength),
+    PRIMITIVE1("TYPE-OF",    FuncTypeOf),
+    PRIMITIVE1("NUMBERP",    FuncNumberp),
+    PRIMITIVE1("ZEROP",      FuncZerop),
+    PRIMITIVE2("=",          FuncNumberEqual),
+    PRIMITIVE2("<",          FuncLess),
+    PRIMITIVE2("<=",         FuncLessEqual),
+    PRIMITIVE2(">",          FuncGreater),
+    PRIMITIVE2(">=",         FuncGreaterEqual),
+    PRIMITIVE2("PLUS",       FuncPlus),
+    PRIMITIVE2("+",          FuncPlus),
+    PRIMITIVE2("MINUS",      FuncMinus),
+    PRIMITIVE2("-",          FuncMinus),
+    PRIMITIVE2("TIMES",      FuncTimes),
+    PRIMITIVE2("*",          FuncTimes),
+    PRIMITIVE2("DIVIDE",     FuncDivide),
+    PRIMITIVE2("/",          FuncDivide),
+    PRIMITIVE2("REMAINDER",  FuncRemainder),
+    PRIMITIVE2("MOD",        FuncRemainder),
+    PRIMITIVE2("%",          FuncRemainder),
+    PRIMITIVE1("ADD1",       FuncAdd1),
+    PRIMITIVE1("1+",         FuncAdd1),
+    PRIMITIVE1("SUB1",       FuncSub1),
+    PRIMITIVE1("1-",         FuncSub1),
+    PRIMITIVE1("LN",         FuncLn),
+    PRIMITIVE1("EXP",        FuncExp),
+    PRIMITIVE2("LOG",        FuncLog),
+    PRIMITIVE2("EXPT",       FuncExpt),
+    PRIMITIVE1("SIN",        FuncSin),
+    PRIMITIVE1("COS",        FuncCos),
+    PRIMITIVE1("TAN",        FuncTan),
+    PRIMITIVE2("EQUAL",      FuncEqual),
+    PRIMITIVE2("SET",        FuncSet),
+    PRIMITIVE1("TRACE",      FuncTrace),
+    PRIMITIVE0("EXIT",       FuncExit),
+    PRIMITIVE0("QUIT",       FuncExit),
+    PRIMITIVE0("READ",       FuncRead),
+    PRIMITIVE1("READ-FROM-STRING", FuncReadFromString),
+    PRIMITIVE1("EVAL",       FuncEval),
+    PRIMITIVE2("APPLY",      FuncApply),
+    PRIMITIVE1("PRIN1",      FuncPrin1),
+    PRIMITIVE1("PRINT",      FuncPrint),
+    PRIMITIVE0("GC",         FuncGC),
+    PRIMITIVE2("MAKE-ARRAY", FuncMakeArray),
+    PRIMITIVE2("AREF",       FuncAref),
+    PRIMITIVEN("ASET",       3, FuncAset),
+    PRIMITIVE1("ARRAY-LENGTH", FuncArrayLength),
+    PRIMITIVE2("ARRAY-ADD",  FuncArrayAdd),
+    PRIMITIVE2("ARRAY-MUL",  FuncArrayMultiply),
+    PRIMITIVE2("ARRAY-DOT",  FuncArrayDot),
+    PRIMITIVE1("ARRAY-SUM",  FuncArraySum),
+    PRIMITIVE1("ARRAY-MIN",  FuncArrayMin),
+    PRIMITIVE1("ARRAY-MAX",  FuncArrayMax),
+    PRIMITIVE1("ARRAY-SIN",  FuncArraySin),
+    PRIMITIVE1("ARRAY-EXP",  FuncArrayExp),
+    PRIMITIVE1("ARRAY-LN",   FuncArrayLn),
+    PRIMITIVE2("MAKE-MATRIX", FuncMakeMatrix),
+    PRIMITIVEN("MATRIX-REF", 3, FuncMatrixRef),
+    PRIMITIVEN("MATRIX-SET", 4, FuncMatrixSet),
+    PRIMITIVE1("MATRIX-ROWS", FuncMatrixRows),
+    PRIMITIVE1("MATRIX-COLUMNS", FuncMatrixColumns),
+    PRIMITIVE2("MATMUL",     FuncMatmul),
+    PRIMITIVE1("TRANSPOSE",  FuncTranspose),
+    PRIMITIVE2("MATRIX-ADD", FuncMatrixAdd),
+    PRIMITIVE2("MATRIX-SUB", FuncMatrixSubtract),
+    PRIMITIVE2("MATRIX-MUL", FuncMatrixMultiply),
+    PRIMITIVE2("MATRIX-SCALE", FuncMatrixScale),
+    PRIMITIVEV("VECTOR",     FuncVector),
+    PRIMITIVEV("MAKE-VECTOR", FuncMakeVector),
+    PRIMITIVE2("VECTOR-REF", FuncVectorRef),
+    PRIMITIVEN("VECTOR-SET!", 3, FuncVectorSet),
+    PRIMITIVE1("VECTOR-LENGTH", FuncVectorLength),
+    PRIMITIVE1("LIST->VECTOR", FuncListToVector),
+    PRIMITIVE1("VECTOR->LIST", FuncVectorToList),
+    PRIMITIVEV("MAKE-HASH-TABLE", FuncMakeHashTable),
+    PRIMITIVEV("GETHASH",    FuncGetHash),
+    PRIMITIVEN("PUTHASH", 3, FuncPutHash),
+    PRIMITIVE2("REMHASH",    FuncRemHash),
+    PRIMITIVE2("MAPHASH",    FuncMapHash),
+    PRIMITIVE1("HASH-TABLE-COUNT", FuncHashTableCount),
+    PRIMITIVE1("STRING-LENGTH", FuncStringLength),
+    PRIMITIVEV("SUBSTRING",  FuncSubstring),
+    PRIMITIVEV("STRING-APPEND", FuncStringAppend),
+    PRIMITIVE2("STRING=",    FuncStringEqual),
+    PRIMITIVEV("STRING-SEARCH", FuncStringSearch),
+    {NULL,         0,    NULL,   NULL,   NULL,   NULL}
 };
 
 Environment *TopLevelEnv = NULL;
 Environment *CurrentEnv = NULL;
 
+// Bindings released by returning functions are kept on this free list
+//  for reuse by the next calls, so that most calls never need to
+//  allocate their bindings from the heap.
+// (The interpreter is single-threaded, so the pool needs no locking.)
+static Environment *FreeEnvironments = NULL;
+
+// Incremented whenever bindings may have been captured or moved, i.e.,
+//  when a closure is made or the garbage collector runs.
+unsigned long EnvironmentEpoch = 0;
+
+// Incremented whenever a global is set, invalidating every call site's cache.
+// (Starts above the version of an empty cache.)
+unsigned long GlobalVersion = 1;
+
+static EnvironmentStatistics Statistics;
+
 bool TraceEnvironment = false;
 
 
@@ -98,30 +162,34 @@ Environment *CreateEnvironment(void)
 {
     Environment *env;
 
-    if (!(env = (Environment *) malloc(sizeof(Environment))))
-      Error("CreateEnvironment():  calloc(%d) failed!\n", sizeof(Environment));
+    if ((env = FreeEnvironments)) {
+        FreeEnvironments = env->parent;
+        Statistics.reused++;
+        Statistics.pooled--;
+    } else if ((env = AllocateEnvironment()))
+      Statistics.allocated++;
+    else
+      Error("CreateEnvironment():  AllocateEnvironment() failed!\n");
 
     return env;
 }
 
-void DestroyEnvironment(Environment *env)
-{
-    free((void *) env);
-}
-
+// Global bindings are kept in the value cells of their symbols, rather than
+//  in the top-level environment, so they are found in constant time.
+// (Hence the initial top-level environment is empty.)
 Environment *InitializeEnvironment(void)
 {
     Environment *env = NULL;
 
     // Bind constants.
     // Note:  Nothing is guaranteeing the constancy of these values!
-    env = Bind(SymbolName(SymbolT), SymbolT, env);
-    env = Bind(SymbolName(SymbolNIL), SymbolNIL, env);
+    SetSymbolValue(SymbolT, SymbolT);
+    SetSymbolValue(SymbolNIL, SymbolNIL);
 
     // Bind primitive functions.
     PsilFunc *prim = PrimitiveFuncs;
     while (prim->name) {
-        env = Bind(SymbolName(Intern(prim->name)), MakeFunc(prim), env);
+        SetSymbolValue(Intern(prim->name), MakeFunc(prim));
         prim++;
     }
 
@@ -134,17 +202,61 @@ void DeInitializeEnvironment(Environment *env)
       ;
 }
 
-Form *Lookup(const char *name, Environment *env)
+// Look up the symbol's local binding, or else its global value.
+Form *Lookup(Form *symbol, Environment *env)
 {
+    const char *name = SymbolName(symbol);
+    Form *value;
+
     while (env)
       if (!strcasecmp(name, env->name))
         return env->value;
       else
         env = env->parent;
 
+    if ((value = SymbolValue(symbol)))
+      return value;
+
     return ErrorForm("Lookup():  Unbound symbol: \"%s\"!\n", name);
 }
 
+// Look up a resolved variable reference by its lexical address.
+Form *LookupLocal(Form *local, Environment *env)
+{
+    for (long depth = LocalDepth(local); env && depth; depth--)
+      env = env->parent;
+
+    if (!env)
+      return ErrorForm("LookupLocal():  Unbound symbol: \"%s\"!\n", SymbolName(LocalSymbol(local)));
+
+#if DEBUG
+    if (strcasecmp(SymbolName(LocalSymbol(local)), env->name))
+      return ErrorForm("LookupLocal():  Misresolved symbol: \"%s\" found \"%s\"!\n",
+                       SymbolName(LocalSymbol(local)), env->name);
+#endif // DEBUG
+
+    return env->value;
+}
+
+// Look up the global function of a call site, using its cache if it is valid.
+Form *LookupCallSite(Form *site)
+{
+    PsilCallSite *cache = CallSiteValue(site);
+    Form *value;
+
+    if (cache->version == GlobalVersion)
+      return cache->value;
+
+    if (!(value = SymbolValue(cache->symbol)))
+      return ErrorForm("Lookup():  Unbound symbol: \"%s\"!\n", SymbolName(cache->symbol));
+
+    cache->value = value;
+    cache->version = GlobalVersion;
+    WriteBarrier(site, value);
+
+    return value;
+}
+
 Environment *LookupBinding(const char *name, Environment *env)
 {
     while (env)
@@ -174,15 +286,36 @@ Environment *Bind(const char *name, Form *value, Environment *env)
     return newEnv;
 }
 
-Environment *SetBinding(const char *name, Form *value, Environment *env)
+// Set a resolved local variable by its lexical address.
+Form *SetLocal(Form *local, Form *value, Environment *env)
+{
+    for (long depth = LocalDepth(local); env && depth; depth--)
+      env = env->parent;
+
+    if (!env)
+      return ErrorForm("SetLocal():  Unbound symbol: \"%s\"!\n", SymbolName(LocalSymbol(local)));
+
+    env->value = value;
+    EnvironmentWriteBarrier(env, value);
+
+    return value;
+}
+
+// Set the variable's local binding, if it has one, or else its global value.
+// (The variable is either a symbol or a resolved local.)
+Environment *SetBinding(Form *variable, Form *value, Environment *env)
 {
     Environment *binding;
 
-    if ((binding = LookupBinding(name, env))) {
+    if (IsLocal(variable))
+      SetLocal(variable, value, env);
+    else if ((binding = LookupBinding(SymbolName(variable), env))) {
         binding->value = value;
-        return env;
+        EnvironmentWriteBarrier(binding, value);
     } else
-      return Bind(name, value, env);
+      SetSymbolValue(variable, value);
+
+    return env;
 }
 
 Environment *Unbind(Environment *env)
@@ -198,12 +331,62 @@ Environment *Unbind(Environment *env)
             fprintf(StandardError, "\tUnbind: %s\n", env->name);
         }
 
-        DestroyEnvironment(env);
+        // Note:  The binding itself may still be captured by a closure,
+        //         so it is left for the garbage collector to reclaim.
 
         return parentEnv;
     }
 }
 
+// Return the bindings from "env" up to (but not including) "parent" to the
+//  free list, if the "EnvironmentEpoch" has not changed since "epoch", which
+//  was read before they were bound.  Otherwise, a closure may have captured
+//  them (or the garbage collector may have moved them), so they are retained
+//  for the garbage collector to reclaim.
+void ReleaseEnvironment(Environment *env, Environment *parent, unsigned long epoch)
+{
+    if (epoch != EnvironmentEpoch) {
+        Statistics.retained++;
+        return;
+    }
+
+    while (env && (env != parent)) {
+        Environment *next = env->parent;
+
+        if (TraceEvaluator) {
+            fprintf(StandardError, "\tRelease: %s\n", env->name);
+        }
+
+#if DEBUG
+        // POISON
+        env->name = NULL;
+        env->value = NULL;
+#endif // DEBUG
+        env->parent = FreeEnvironments;
+        FreeEnvironments = env;
+        Statistics.released++;
+        Statistics.pooled++;
+
+        env = next;
+    }
+}
+
+// Discard the free list.
+// (This must be called whenever the garbage collector runs, since pooled
+//  bindings are unreachable and so their cells may be reclaimed.)
+void FlushEnvironmentPool(void)
+{
+    FreeEnvironments = NULL;
+    Statistics.flushed += Statistics.pooled;
+    Statistics.pooled = 0;
+    EnvironmentEpoch++;
+}
+
+void GetEnvironmentStatistics(EnvironmentStatistics *stats)
+{
+    *stats = Statistics;
+}
+
 void PrintEnvironment(Environment *env, FILE *outstream, bool verbose)
 {
     if (env) {
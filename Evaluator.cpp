@@ -27,6 +27,8 @@ bool TraceEvaluator = false;
 
 Environment *BindArgs(Form *arglist, Form *args, Environment *env)
 {
+    int roots = SaveRoots();
+
     if (TraceEvaluator) {
         fprintf(StandardError, "EVAL:  BindArgs(");
         Print(arglist, StandardError);
@@ -37,36 +39,48 @@ Environment *BindArgs(Form *arglist, Form *args, Environment *env)
         fprintf(StandardError, ")\n");
     }
 
-    if (IsNull(arglist) || IsNull(args)) {
-        if (!IsNull(args))
-          Error("BindArgs():  Ignoring extra arguments!\n");
-        else if (!IsNull(arglist)) {
-            Error("BindArgs():  Binding missing arguments to NIL!\n");
-            while (!IsNull(arglist)) {
-                Form *argName = Car(arglist);
-                if (IsSymbol(argName))
-                  env = Bind(SymbolName(argName), SymbolNIL, env);
-                else
-                  Error("BindArgs():  Ignoring extra non-symbol argument!\n");
-                arglist = Cdr(arglist);
-            }
-        }
-        return env;
-    } else {
+    // The argument values are evaluated while the new bindings are being built.
+    ProtectForm(&arglist);
+    ProtectForm(&args);
+    ProtectEnvironment(&env);
+
+    while (!IsNull(arglist) && !IsNull(args)) {
         Form *argName = Car(arglist);
         if (IsSymbol(argName)) {
             Form *argValue = Eval(Car(args), CurrentEnv);
-            return BindArgs(Cdr(arglist), Cdr(args),
-                            Bind(SymbolName(argName), argValue, env));
+            env = Bind(SymbolName(Car(arglist)), argValue, env);
+            arglist = Cdr(arglist);
+            args = Cdr(args);
         } else {
             Error("BindArgs():  Non-symbol argument!\n");
+            RestoreRoots(roots);
             return env;
         }
     }
+
+    if (!IsNull(args))
+      Error("BindArgs():  Ignoring extra arguments!\n");
+    else if (!IsNull(arglist)) {
+        Error("BindArgs():  Binding missing arguments to NIL!\n");
+        while (!IsNull(arglist)) {
+            Form *argName = Car(arglist);
+            if (IsSymbol(argName))
+              env = Bind(SymbolName(argName), SymbolNIL, env);
+            else
+              Error("BindArgs():  Ignoring extra non-symbol argument!\n");
+            arglist = Cdr(arglist);
+        }
+    }
+
+    RestoreRoots(roots);
+
+    return env;
 }
 
 bool EvalArgs(Form *args, Environment *env)
 {
+    int roots = SaveRoots();
+
     if (TraceEvaluator) {
         fprintf(StandardError, "EVAL:  EvalArgs(");
         Print(args, StandardError);
@@ -75,21 +89,28 @@ bool EvalArgs(Form *args, Environment *env)
         fprintf(StandardError, ")\n");
     }
 
+    ProtectForm(&args);
+    ProtectEnvironment(&env);
+
     while (!IsNull(args)) {
         if (!IsCons(args)) {
             Error("EvalArgs():  Invalid argument list!\n");
+            RestoreRoots(roots);
             return false;
         }
         Push(Eval(Car(args), env));
         args = Cdr(args);
     }
 
+    RestoreRoots(roots);
+
     return true;
 }
 
 Form *EvalBody(Form *forms, Environment *env)
 {
-    Form *retval, *head, *tail;
+    Form *retval = SymbolNIL;
+    int roots = SaveRoots();
 
     if (TraceEvaluator) {
         fprintf(StandardError, "EVAL:  EvalBody(");
@@ -99,66 +120,188 @@ Form *EvalBody(Form *forms, Environment *env)
         fprintf(StandardError, ")\n");
     }
 
-    if (IsNull(forms))
-      return SymbolNIL;
+    ProtectForm(&forms);
+    ProtectEnvironment(&env);
 
-    head = Car(forms);
-    tail = Cdr(forms);
-
-    retval = Eval(head, env);
+    while (!IsNull(forms)) {
+        retval = Eval(Car(forms), env);
+        forms = Cdr(forms);
+    }
 
-    if (IsNull(tail))
-      return retval;
+    RestoreRoots(roots);
 
-    return EvalBody(tail, env);
+    return retval;
 }
 
-Form *Eval(Form *form, Environment *env)
+static void TraceEval(Form *form, Environment *env)
 {
-    if (TraceEvaluator) {
-        fprintf(StandardError, "EVAL:  Eval(");
-        Print(form, StandardError);
-        fprintf(StandardError, ", ");
-        PrintEnvironment(env, StandardError, TraceEnvironment);
-        fprintf(StandardError, ")\n");
-    }
+    fprintf(StandardError, "EVAL:  Eval(");
+    Print(form, StandardError);
+    fprintf(StandardError, ", ");
+    PrintEnvironment(env, StandardError, TraceEnvironment);
+    fprintf(StandardError, ")\n");
+}
 
+static Form *EvalAtom(Form *form, Environment *env)
+{
     if (IsNull(form)) {
         return SymbolNIL;
     } else if (IsAtom(form)) {
-        if (IsNumber(form) || IsString(form))
+        if (IsNumber(form) || IsString(form) || IsVector(form))
           return form;
+        else if (IsLocal(form))
+          return LookupLocal(form, env);
+        else if (IsCallSite(form))
+          return LookupCallSite(form);
         else
-          return Lookup(SymbolName(form), env);
-    } else if (IsCons(form)) {
-        if (IsQuote(Car(form)))
-          return Cadr(form);
-        else if (IsIf(Car(form)))
-          return Eval((Eval(Cadr(form), env) != SymbolNIL ? Caddr(form) : Cadddr(form)), env);
-        else if (IsLambda(Car(form)))
-          return MakeClosure(Cadr(form), Cddr(form), env);
-        else if (IsAssignment(form)) {
-            Form *value = Eval(Caddr(form), env);
-            CurrentEnv = SetBinding(SymbolName(Cadr(form)), value, env);
-            return value;
+          return Lookup(form, env);
+    } else
+      return ErrorForm("Eval():  Invalid form type!\n");
+}
+
+// N.B.:  Forms in tail position (i.e., the branches of "if" and the last form of
+//        a closure's body) are evaluated by looping rather than recursing, and a
+//        closure applied in tail position replaces the bindings of the one before,
+//        so iteration by tail recursion takes constant C stack and environment depth.
+Form *Eval(Form *form, Environment *env)
+{
+    Form *retval, *func = SymbolNIL;
+    // The bindings of the closure most recently applied in tail position, if any.
+    Environment *callerEnv = env, *frameEnv = NULL, *frameParent = NULL;
+    unsigned long frameEpoch = 0;
+    int roots;
+
+    if (TraceEvaluator)
+      TraceEval(form, env);
+
+    if (!IsCons(form))
+      return EvalAtom(form, env);
+
+    // Compound forms evaluate their sub-forms, so protect them from the collector.
+    roots = SaveRoots();
+    ProtectForm(&form);
+    ProtectForm(&func);
+    ProtectEnvironment(&env);
+    ProtectEnvironment(&callerEnv);
+    ProtectEnvironment(&frameEnv);
+    ProtectEnvironment(&frameParent);
+
+    for (;;) {
+        // This is a safe point for garbage collection.
+        if (GCRequested)
+          GCSafePoint();
+
+        if (IsQuote(Car(form))) {
+            retval = Cadr(form);
+            break;
+        } else if (IsIf(Car(form))) {
+            Form *test = Eval(Cadr(form), env);
+            form = (test != SymbolNIL ? Caddr(form) : Cadddr(form));
+        } else if (IsLambda(Car(form))) {
+            Form *body = ResolveBody(Cadr(form), Cddr(form), env);
+            retval = MakeClosure(Cadr(form), body, env);
+            if (UseVM && IsValidArglist(Cadr(form)))
+              SetLambdaCode(retval, CompileBody(Cadr(form), body));
+            break;
+        } else if (IsResolvedLambda(Car(form))) {
+            retval = MakeClosure(Cadr(form), Cddr(form), env);
+            break;
+        } else if (IsAssignment(form)) {
+            retval = Eval(Caddr(form), env);
+            CurrentEnv = SetBinding(Cadr(form), retval, env);
+            break;
         } else if (IsDefinition(form)) {
             // Note:  This supports recursive function definitions, but it allows:
             //        "(define x x)" ==> x := NIL, and also:
             //        "(define x 1) (define x y)" ==> x := NIL if "y" is undefined!
-            env = SetBinding(SymbolName(Cadr(form)), SymbolNIL, env);
-            Form *value = Eval(Caddr(form), env);
-            CurrentEnv = SetBinding(SymbolName(Cadr(form)), value, env);
-            return value;
-        } else
-          return Apply(Car(form), Cdr(form), env);
-    } else {
-        return ErrorForm("Eval():  Invalid form type!\n");
+            env = SetBinding(Cadr(form), SymbolNIL, env);
+            retval = Eval(Caddr(form), env);
+            CurrentEnv = SetBinding(Cadr(form), retval, env);
+            break;
+        } else {
+            func = Car(form);
+            if (IsLocal(func))
+              func = LookupLocal(func, env);
+            else if (IsCallSite(func))
+              func = LookupCallSite(func);
+            else if (IsSymbol(func))
+              func = Lookup(func, env);
+            else if (IsCons(func) && !IsLambdaForm(func))
+              func = Eval(func, env);
+
+            if (IsLambdaForm(func)) {
+                // A lambda form is applied in the caller's environment, so its bindings
+                //  are made on the caller's, which thus stay live until the collector reclaims them.
+                if (TraceEvaluator)
+                  fprintf(StandardError, "\tTail Apply(LAMBDA)\n");
+                CurrentEnv = env;
+                unsigned long epoch = EnvironmentEpoch;
+                Environment *funcEnv = BindArgs(Cadr(func), Cdr(form), env);
+                frameEnv = funcEnv;
+                frameParent = env;
+                frameEpoch = epoch;
+                env = CurrentEnv = funcEnv;
+                form = Cddr(func);
+            } else if (!IsClosure(func) || LambdaCode(func)) {
+                // (Let "Apply()" report an undefined function by name.)
+                retval = Apply((IsNull(func) && !IsCons(Car(form))) ? Car(form) : func, Cdr(form), env);
+                break;
+            } else {
+                if (TraceEvaluator) {
+                    fprintf(StandardError, "\tTail Apply(");
+                    Print(func, StandardError);
+                    fprintf(StandardError, ")\n");
+                }
+
+                CurrentEnv = env;
+                unsigned long epoch = EnvironmentEpoch;
+                Environment *funcEnv = BindArgs(LambdaArglist(func), Cdr(form), LambdaEnvironment(func));
+
+                // The arguments have been evaluated, so the previous frame's bindings are dead.
+                if (frameEnv)
+                  ReleaseEnvironment(frameEnv, frameParent, frameEpoch);
+                frameEnv = funcEnv;
+                frameParent = LambdaEnvironment(func);
+                frameEpoch = epoch;
+                env = CurrentEnv = funcEnv;
+                form = LambdaBody(func);
+            }
+
+            if (IsNull(form)) {
+                retval = SymbolNIL;
+                break;
+            }
+            for ( ; !IsNull(Cdr(form)); form = Cdr(form))
+              Eval(Car(form), env);
+            form = Car(form);
+        }
+
+        // Continue with the form in tail position.
+        if (TraceEvaluator)
+          TraceEval(form, env);
+
+        if (!IsCons(form)) {
+            retval = EvalAtom(form, env);
+            break;
+        }
     }
+
+    if (frameEnv) {
+        CurrentEnv = callerEnv;
+        ReleaseEnvironment(frameEnv, frameParent, frameEpoch);
+    }
+
+    RestoreRoots(roots);
+
+    return retval;
 }
 
 Form *Apply(Form *func, Form *args, Environment *env)
 {
     Form *retval;
+    Environment *funcEnv;
+    unsigned long epoch;
+    int roots = SaveRoots();
 
     if (TraceEvaluator) {
         fprintf(StandardError, "EVAL:  Apply(");
@@ -170,53 +313,92 @@ Form *Apply(Form *func, Form *args, Environment *env)
         fprintf(StandardError, ")\n");
     }
 
+    // N.B.:  Since the arguments are evaluated while the function is being applied,
+    //        re-fetch anything derived from these after calling "BindArgs()".
+    ProtectForm(&func);
+    ProtectForm(&args);
+    ProtectEnvironment(&env);
+
     if (IsFunc(func)) {
         PsilFunc *pfunc = FuncValue(func);
-        int nargs = Length(args);
-        if (nargs != pfunc->nargs)
-          return ErrorForm("Apply():  Incorrect number of arguments to function \"%s\": Supplied: %d; Expected: %d\n", pfunc->name, nargs, pfunc->nargs);
-        if (!EvalArgs(args, env))
-          return ErrorForm("Apply():  EvalArgs() failed!\n");
-        else
-          return (pfunc->func)();
+        if (pfunc->func1 && IsCons(args) && IsNull(Cdr(args)))
+          retval = (pfunc->func1)(Eval(Car(args), env));
+        else if (pfunc->func2 && IsCons(args) && IsCons(Cdr(args)) && IsNull(Cddr(args))) {
+            // (Keep the first argument's value while the second is evaluated.)
+            Form *x = Eval(Car(args), env);
+            ProtectForm(&x);
+            Form *y = Eval(Cadr(args), env);
+            retval = (pfunc->func2)(x, y);
+        } else {
+            int nargs = Length(args);
+            if ((nargs != pfunc->nargs) && (pfunc->nargs != kVariadicArgs))
+              return ErrorForm("Apply():  Incorrect number of arguments to function \"%s\": Supplied: %d; Expected: %d\n", pfunc->name, nargs, pfunc->nargs);
+            if (!EvalArgs(args, env))
+              return ErrorForm("Apply():  EvalArgs() failed!\n");
+            else
+              retval = CallPrimitive(pfunc, nargs);
+        }
     } else if (IsClosure(func)) {
-        Form *arglist = LambdaArglist(func);
-        Form *body = LambdaBody(func);
-        Environment *lexicalEnv = LambdaEnvironment(func);
-        Environment *origEnv = env;
         CurrentEnv = env;
         if (TraceEvaluator) {
             fprintf(StandardError, "\tIsClosure() ==> true\n");
         }
-        retval = EvalBody(body, CurrentEnv = BindArgs(arglist, args, lexicalEnv));
-        CurrentEnv = origEnv;
-        return retval;
+        epoch = EnvironmentEpoch;
+        funcEnv = BindArgs(LambdaArglist(func), args, LambdaEnvironment(func));
+        if (LambdaCode(func))
+          retval = Execute(LambdaCode(func), CurrentEnv = funcEnv);
+        else
+          retval = EvalBody(LambdaBody(func), CurrentEnv = funcEnv);
+        CurrentEnv = env;
+        ReleaseEnvironment(funcEnv, LambdaEnvironment(func), epoch);
     } else if (IsLambdaForm(func)) {
         if (TraceEvaluator) {
             fprintf(StandardError, "\tIsLambdaForm() ==> true\n");
         }
-        Form *arglist = Cadr(func);
-        Form *body = Cddr(func);
-        Environment *origEnv = env;
         CurrentEnv = env;
-        retval = EvalBody(body, CurrentEnv = BindArgs(arglist, args, env));
-        while (CurrentEnv && (CurrentEnv != origEnv))
+        epoch = EnvironmentEpoch;
+        funcEnv = BindArgs(Cadr(func), args, env);
+        retval = EvalBody(Cddr(func), CurrentEnv = funcEnv);
+        while (CurrentEnv && (CurrentEnv != env))
           CurrentEnv = Unbind(CurrentEnv);
-        return retval;
+        ReleaseEnvironment(funcEnv, env, epoch);
     } else if (IsCons(func)) {
         if (TraceEvaluator) {
             fprintf(StandardError, "\tIsCons() ==> true\n");
         }
-        return Apply(Eval(func, env), args, env);
+        Form *funcValue = Eval(func, env);
+        retval = Apply(funcValue, args, env);
+    } else if (IsLocal(func)) {
+        if (TraceEvaluator) {
+            fprintf(StandardError, "\tIsLocal() ==> true\n");
+        }
+        Form *localValue = LookupLocal(func, env);
+        if (localValue != SymbolNIL)
+          retval = Apply(localValue, args, env);
+        else
+          return ErrorForm("Apply():  Undefined function symbol: \"%s\"!\n", SymbolName(LocalSymbol(func)));
+    } else if (IsCallSite(func)) {
+        if (TraceEvaluator) {
+            fprintf(StandardError, "\tIsCallSite() ==> true\n");
+        }
+        Form *siteValue = LookupCallSite(func);
+        if (siteValue != SymbolNIL)
+          retval = Apply(siteValue, args, env);
+        else
+          return ErrorForm("Apply():  Undefined function symbol: \"%s\"!\n", SymbolName(CallSiteValue(func)->symbol));
     } else if (IsSymbol(func)) {
         if (TraceEvaluator) {
             fprintf(StandardError, "\tIsSymbol() ==> true\n");
         }
-        Form *symbolValue = Lookup(SymbolName(func), env);
+        Form *symbolValue = Lookup(func, env);
         if (symbolValue != SymbolNIL)
-          return Apply(symbolValue, args, env);
+          retval = Apply(symbolValue, args, env);
         else
           return ErrorForm("Apply():  Undefined function symbol: \"%s\"!\n", SymbolName(func));
     } else
       return ErrorForm("Apply():  Invalid function object!\n");
+
+    RestoreRoots(roots);
+
+    return retval;
 }
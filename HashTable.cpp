@@ -0,0 +1,397 @@
+/*
+    File:   HashTable.cpp
+    Author: ***PSI***
+    Date:   Mon Oct 19 00:52:36 2026
+
+    Description:
+       Psil hash tables.
+
+       A hash table maps keys to values under either "EQ" or "EQUAL", and
+       is open-addressed with linear probing.  Each entry keeps its key's
+       hash, so probes compare hashes before keys, and entries are moved
+       without rehashing their keys.  Removed entries are marked deleted,
+       rather than emptied, so that probes continue past them.
+
+       Growing a table does not move all of its entries at once:  The new
+       entries are allocated, and every later insertion or removal moves a
+       few more of the old entries into them, while lookups search both.
+       The new entries are at most half full to start with, so the old ones
+       are all moved well before they fill up in turn.
+
+       Keys which are hashed by value, i.e., numbers, symbols and (under
+       "EQUAL") strings and lists of them, are hashed consistently with
+       "Eq()" and "Equal()".  Others can only be hashed by address, which changes when
+       a young form is promoted, so a table given such a young key rehashes
+       its entries once after the next collection.
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "Psil.h"
+
+
+// Define constants.
+
+
+static const long kInitialCapacity = 8;
+
+// Old entries moved into the new entries with each insertion or removal.
+static const long kMigrationSteps = 8;
+
+// The most conses hashed within an "EQUAL" key.
+// (Equal keys have the same structure, so they hash the same prefix of it.)
+static const long kMaxHashConses = 64;
+
+
+// Define functions.
+
+
+// (The finalizer of SplitMix64.)
+static inline unsigned long Mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+
+    return (unsigned long) x;
+}
+
+// Returns the hash of the form under the test, noting whether it depends on the address of a young form.
+static unsigned long HashForm(Form *form, PsilHashTest test, long &budget, bool &young)
+{
+    if (IsInteger(form))
+      return Mix((uint64_t) IntegerValue(form));
+    else if (IsSymbol(form))
+      return Mix(SymbolHash(form));
+    else if (IsBignum(form)) {
+        PsilBignum *bignum = &form->value.bignum;
+        uint64_t hash = (uint64_t) bignum->sign;
+        for (long index = 0; index < bignum->length; index++)
+          hash = Mix(hash + bignum->digits[index]);
+        return (unsigned long) hash;
+    } else if ((test == kPsilHashEqual) && IsFlonum(form)) {
+        // (So that 0.0 and -0.0, which are "=", hash the same.)
+        double value = FlonumValue(form) + 0.0;
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return Mix(bits);
+    } else if ((test == kPsilHashEqual) && IsString(form)) {
+        // (FNV-1a.)
+        const unsigned char *chars = (const unsigned char *) StringValue(form);
+        uint64_t hash = 14695981039346656037ULL;
+        for (long index = 0; index < StringLength(form); index++)
+          hash = (hash ^ chars[index]) * 1099511628211ULL;
+        return Mix(hash);
+    } else if ((test == kPsilHashEqual) && IsCons(form)) {
+        uint64_t hash = kPsilCons;
+        for ( ; IsCons(form) && (budget > 0); form = Cdr(form), budget--)
+          hash = Mix(hash + HashForm(Car(form), test, budget, young));
+        if (budget > 0)
+          hash = Mix(hash + HashForm(form, test, budget, young));
+        return (unsigned long) hash;
+    }
+
+    if (IsYoungForm(form))
+      young = true;
+
+    return Mix((uint64_t) (uintptr_t) form);
+}
+
+// Returns the hash of the key, which is never that of an empty or deleted entry.
+static unsigned long HashKey(PsilHashTable *table, Form *key, bool &young)
+{
+    long budget = kMaxHashConses;
+    unsigned long hash = HashForm(key, table->test, budget, young);
+
+    return (hash > kDeletedHash) ? hash : (hash + kDeletedHash + 1);
+}
+
+// Note that the table has been given a key hashed by the address of a young form,
+//  so it must be rehashed after the next collection.
+static void AddedYoungKey(PsilHashTable *table)
+{
+    table->youngKeys = true;
+    table->epoch = GCEpoch;
+}
+
+static inline bool KeysMatch(PsilHashTable *table, Form *x, Form *y)
+{
+    return (table->test == kPsilHashEq) ? Eq(x, y) : (Equal(x, y) == SymbolT);
+}
+
+// Returns the entry with the key, or NULL.
+static PsilHashEntry *FindEntry(PsilHashTable *table, PsilHashEntry *entries, long capacity,
+                                Form *key, unsigned long hash)
+{
+    if (!entries)
+      return NULL;
+
+    for (long probe = hash & (capacity - 1); ; probe = (probe + 1) & (capacity - 1)) {
+        PsilHashEntry *entry = &entries[probe];
+        if (entry->hash == kEmptyHash)
+          return NULL;
+        else if ((entry->hash == hash) && KeysMatch(table, entry->key, key))
+          return entry;
+    }
+}
+
+// Returns the first empty or deleted entry for the hash.
+static PsilHashEntry *FreeEntry(PsilHashEntry *entries, long capacity, unsigned long hash)
+{
+    long probe = hash & (capacity - 1);
+
+    while (entries[probe].hash > kDeletedHash)
+      probe = (probe + 1) & (capacity - 1);
+
+    return &entries[probe];
+}
+
+// Add an entry whose key is known not to be in the new entries.
+static void AddEntry(PsilHashTable *table, unsigned long hash, Form *key, Form *value)
+{
+    PsilHashEntry *entry = FreeEntry(table->entries, table->capacity, hash);
+
+    if (entry->hash == kEmptyHash)
+      table->used++;
+    entry->hash = hash;
+    entry->key = key;
+    entry->value = value;
+}
+
+static PsilHashEntry *NewEntries(long capacity)
+{
+    PsilHashEntry *entries = (PsilHashEntry *) calloc(capacity, sizeof(PsilHashEntry));
+
+    if (!entries)
+      ErrorForm("HashTable():  Failed to allocate %ld entries!\n", capacity);
+
+    AddExternalBytes(capacity * sizeof(PsilHashEntry));
+
+    return entries;
+}
+
+static void FreeEntries(PsilHashEntry *entries, long capacity)
+{
+    free((void *) entries);
+    AddExternalBytes(-capacity * sizeof(PsilHashEntry));
+}
+
+// Move up to "steps" of the old entries into the new ones.
+static void Migrate(PsilHashTable *table, long steps)
+{
+    if (!table->oldEntries)
+      return;
+
+    for ( ; (steps > 0) && (table->migrated < table->oldCapacity); steps--) {
+        PsilHashEntry *entry = &table->oldEntries[table->migrated++];
+        if (entry->hash > kDeletedHash) {
+            AddEntry(table, entry->hash, entry->key, entry->value);
+            // (Leave it deleted, so that probes for the remaining old entries continue past it.)
+            entry->hash = kDeletedHash;
+        }
+    }
+
+    if (table->migrated == table->oldCapacity) {
+        FreeEntries(table->oldEntries, table->oldCapacity);
+        table->oldEntries = NULL;
+        table->oldCapacity = table->migrated = 0;
+    }
+}
+
+// Start moving the entries into new ones with room for at least twice as many,
+//  which also clears out those deleted.
+// (Tables never shrink, so the old entries are no more than the new.)
+static void Grow(PsilHashTable *table)
+{
+    long capacity = table->capacity;
+
+    // (Finish any previous move first, though it is normally done long before.)
+    Migrate(table, table->oldCapacity);
+
+    while (capacity < 2 * (table->count + 1))
+      capacity *= 2;
+
+    table->oldEntries = table->entries;
+    table->oldCapacity = table->capacity;
+    table->migrated = 0;
+    table->entries = NewEntries(capacity);
+    table->capacity = capacity;
+    table->used = 0;
+}
+
+// Rehash every entry, since some keys hashed by address may have moved.
+static void Rehash(PsilHashTable *table)
+{
+    PsilHashEntry *entries = table->entries, *oldEntries = table->oldEntries;
+    long capacity = table->capacity, oldCapacity = table->oldCapacity;
+    long newCapacity = capacity;
+
+    while (newCapacity < 2 * (table->count + 1))
+      newCapacity *= 2;
+
+    table->entries = NewEntries(newCapacity);
+    table->capacity = newCapacity;
+    table->used = 0;
+    table->oldEntries = NULL;
+    table->oldCapacity = table->migrated = 0;
+    table->youngKeys = false;
+
+    for (int pass = 0; pass < 2; pass++) {
+        PsilHashEntry *from = pass ? oldEntries : entries;
+        long size = pass ? oldCapacity : capacity;
+        for (long index = 0; index < size; index++)
+          if (from[index].hash > kDeletedHash) {
+              bool young = false;
+              AddEntry(table, HashKey(table, from[index].key, young), from[index].key, from[index].value);
+              if (young)
+                AddedYoungKey(table);
+          }
+    }
+
+    FreeEntries(entries, capacity);
+    if (oldEntries)
+      FreeEntries(oldEntries, oldCapacity);
+}
+
+// Returns the table, after checking that it is one, and rehashing it if a collection may have moved its keys.
+static PsilHashTable *TableValue(const char *name, Form *table)
+{
+    if (!IsHashTable(table)) {
+        ErrorForm("%s():  Non-hash-table argument!\n", name);
+        return NULL;
+    }
+
+    PsilHashTable *ptable = HashTableValue(table);
+
+    if (ptable->youngKeys && (ptable->epoch != GCEpoch))
+      Rehash(ptable);
+
+    return ptable;
+}
+
+static PsilHashEntry *Lookup(PsilHashTable *table, Form *key, unsigned long hash)
+{
+    PsilHashEntry *entry = FindEntry(table, table->entries, table->capacity, key, hash);
+
+    return entry ? entry : FindEntry(table, table->oldEntries, table->oldCapacity, key, hash);
+}
+
+Form *MakeHashTable(Form *test)
+{
+    PsilHashTest hashTest;
+    Form *form;
+
+    if (IsNull(test) || EqStr(test, "EQ"))
+      hashTest = kPsilHashEq;
+    else if (EqStr(test, "EQUAL"))
+      hashTest = kPsilHashEqual;
+    else
+      return ErrorForm("MakeHashTable():  Test must be EQ or EQUAL!\n");
+
+    PsilHashEntry *entries = NewEntries(kInitialCapacity);
+
+    if ((form = AllocateForm(kPsilHashTable)) == NULL) {
+        FreeEntries(entries, kInitialCapacity);
+        return ErrorForm("MakeHashTable():  AllocateForm() failed!\n");
+    }
+
+    form->value.hashTable.entries = entries;
+    form->value.hashTable.capacity = kInitialCapacity;
+    form->value.hashTable.test = hashTest;
+
+    return form;
+}
+
+Form *GetHash(Form *key, Form *table, Form *missing)
+{
+    PsilHashTable *ptable = TableValue("GetHash", table);
+    bool young = false;
+    PsilHashEntry *entry = Lookup(ptable, key, HashKey(ptable, key, young));
+
+    return entry ? entry->value : missing;
+}
+
+Form *PutHash(Form *key, Form *value, Form *table)
+{
+    PsilHashTable *ptable = TableValue("PutHash", table);
+    bool young = false;
+    unsigned long hash = HashKey(ptable, key, young);
+    PsilHashEntry *entry = Lookup(ptable, key, hash);
+
+    if (entry)
+      entry->value = value;
+    else {
+        if (4 * (ptable->used + 1) > 3 * ptable->capacity)
+          Grow(ptable);
+        AddEntry(ptable, hash, key, value);
+        if (young)
+          AddedYoungKey(ptable);
+        ptable->count++;
+    }
+
+    Migrate(ptable, kMigrationSteps);
+
+    // (The table is in the old generation.)
+    WriteBarrier(table, key);
+    WriteBarrier(table, value);
+
+    return value;
+}
+
+Form *RemHash(Form *key, Form *table)
+{
+    PsilHashTable *ptable = TableValue("RemHash", table);
+    bool young = false;
+    PsilHashEntry *entry = Lookup(ptable, key, HashKey(ptable, key, young));
+
+    if (entry) {
+        entry->hash = kDeletedHash;
+        entry->key = entry->value = NULL;
+        ptable->count--;
+    }
+
+    Migrate(ptable, kMigrationSteps);
+
+    return entry ? SymbolT : SymbolNIL;
+}
+
+// Apply the function to each key and value.
+// (The entries are copied first, so the function may change the table.)
+Form *MapHash(Form *func, Form *table)
+{
+    PsilHashTable *ptable = TableValue("MapHash", table);
+    Form *entries = SymbolNIL;
+    int roots = SaveRoots();
+
+    for (int pass = 0; pass < 2; pass++) {
+        PsilHashEntry *tableEntries = pass ? ptable->oldEntries : ptable->entries;
+        long capacity = pass ? ptable->oldCapacity : ptable->capacity;
+        for (long index = 0; index < capacity; index++)
+          if (tableEntries[index].hash > kDeletedHash)
+            entries = Cons(Cons(tableEntries[index].key, tableEntries[index].value), entries);
+    }
+
+    ProtectForm(&func);
+    ProtectForm(&entries);
+
+    for ( ; !IsNull(entries); entries = Cdr(entries)) {
+        Form *args = Cons(Cons(SymbolQUOTE, Cons(Car(Car(entries)), SymbolNIL)),
+                          Cons(Cons(SymbolQUOTE, Cons(Cdr(Car(entries)), SymbolNIL)), SymbolNIL));
+        Apply(func, args, CurrentEnv);
+    }
+
+    RestoreRoots(roots);
+
+    return SymbolNIL;
+}
+
+Form *HashTableCount(Form *table)
+{
+    return MakeInteger(TableValue("HashTableCount", table)->count);
+}
@@ -0,0 +1,915 @@
+/*
+    File:   Heap.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 10:12:37 2026
+
+    Description:
+       Psil heap and garbage collector.
+
+       All forms and environment bindings are allocated from fixed-size
+       cells in aligned heap pages, with one pool of pages per type (i.e.,
+       "Big Bag Of Pages", or BiBOP, allocation.)  Since the type of every
+       cell in a page is recorded in the page header, forms need not store
+       their type, and each cell need only be as large as the data for its
+       type, e.g., a CONS cell is just its CAR and CDR.
+
+       The heap is divided into two generations.  New objects are bump
+       allocated in the young pages of their pool (the "nursery".)  When the
+       nursery fills up, a copying minor collection promotes its survivors
+       into cells of the old pages, whose free cells are kept on free lists.
+       When the old generation has doubled since the last full collection,
+       it is collected by a precise mark-and-sweep collector (after a minor
+       collection has emptied the nursery.)
+
+       Stores of young objects into old ones must be recorded by calling one
+       of the write barrier functions, so that the minor collector can find
+       them without scanning the whole old generation.
+
+       The roots are the top-level and current environments, the stack
+       machine's stack, the reader's interned symbols, and any locals the
+       evaluator has explicitly protected via "ProtectForm()" and
+       "ProtectEnvironment()".  Since the minor collector moves objects,
+       C code must re-fetch anything derived from a protected form after a
+       safe point.
+
+       Allocation never collects.  Instead, it requests a collection,
+       which is performed at the next safe point, i.e., when "Eval()"
+       starts evaluating a compound form, or when explicitly requested
+       by the "(gc)" primitive or the ":GC" command.  Thus C code only
+       needs to protect the forms it holds across a call to "Eval()".
+
+       Define GC_POISON (as DEBUG builds do) to overwrite released cells and
+       nursery pages, so that an unprotected pointer to a moved or freed
+       object fails quickly, rather than usually finding the old contents.
+*/
+
+
+// Include declarations files.
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "Psil.h"
+
+
+// Define constants.
+
+
+// (Heap pages are aligned to their size, so a cell's page is found by masking.)
+
+// Cells must be able to hold a free list or forwarding pointer.
+const size_t kMinCellSize = sizeof(void *);
+
+const size_t kCellAlignment = 16;
+
+const int kBitsPerWord = 8 * sizeof(unsigned long);
+
+// Enough mark bits for the smallest possible cell.
+const int kMarkWords = kPageSize / kMinCellSize / kBitsPerWord;
+
+// Request a minor collection once this many young pages have been allocated.
+const long kNurseryPages = 64;
+
+// Never collect the old generation automatically until at least this much is in use.
+const long kMinGCThreshold = 4 * 1024 * 1024;
+
+const int kInitialCellStackSize = 1024;
+
+
+// Define types.
+
+
+typedef struct HeapPool HeapPool;
+
+typedef struct HeapPage {
+    // (Must be first.)
+    PageHeader       header;
+    struct HeapPage *next;
+    HeapPool        *pool;
+    char            *cells;
+    int              used;
+    bool             young;
+    // Mark bits for old pages, or forwarding bits for young pages.
+    unsigned long    marks[kMarkWords];
+    // Which old cells are in the remembered set.
+    unsigned long    remembered[kMarkWords];
+} HeapPage;
+
+struct HeapPool {
+    const char *name;
+    PsilType    type;
+    size_t      cellSize;
+    bool        hasNursery;
+    int         cellsPerPage;
+    // The old generation.
+    HeapPage   *pages;
+    void       *freeList;
+    long        numPages;
+    // The young generation.
+    HeapPage   *youngPages;
+    char       *top;
+    char       *limit;
+};
+
+typedef void (CellVisitor)(void **cell);
+
+// A growable stack of cells, used for the root, remembered and work lists.
+typedef struct CellStack {
+    void **cells;
+    int    size;
+    int    count;
+} CellStack;
+
+
+// Define global variables.
+
+
+// Symbols and primitive functions are never reclaimed,
+//  so they are allocated directly in the old generation.
+static HeapPool SymbolPool      = {"SYMBOL",      kPsilSymbol,      sizeof(PsilSymbol),  false};
+static HeapPool IntegerPool     = {"INTEGER",     kPsilInteger,     sizeof(PsilInteger), true};
+static HeapPool FlonumPool      = {"FLONUM",      kPsilFlonum,      sizeof(PsilFlonum),  true};
+static HeapPool StringPool      = {"STRING",      kPsilString,      sizeof(PsilString),  true};
+// (Long strings are also strings, but are allocated by "AllocateLongString()", so their characters are freed with them.)
+static HeapPool LongStringPool  = {"LONGSTRING",  kPsilString,      sizeof(PsilString),  false};
+static HeapPool ConsPool        = {"CONS",        kPsilCons,        sizeof(PsilCons),    true};
+static HeapPool FuncPool        = {"FUNC",        kPsilFunc,        sizeof(PsilFunc *),  false};
+static HeapPool LambdaPool      = {"LAMBDA",      kPsilLambda,      sizeof(PsilLambda),  true};
+static HeapPool LocalPool       = {"LOCAL",       kPsilLocal,       sizeof(PsilLocal),   true};
+// (Code is only reclaimed by full collections, which free its instructions and constants.)
+static HeapPool CodePool        = {"CODE",        kPsilCode,        sizeof(PsilCode),    false};
+static HeapPool CallSitePool    = {"CALLSITE",    kPsilCallSite,    sizeof(PsilCallSite), true};
+// (Likewise bignums, arrays, matrices, vectors and hash tables, whose digits and elements are freed with them.)
+static HeapPool BignumPool      = {"BIGNUM",      kPsilBignum,      sizeof(PsilBignum),  false};
+static HeapPool ArrayPool       = {"ARRAY",       kPsilArray,       sizeof(PsilArray),   false};
+static HeapPool MatrixPool      = {"MATRIX",      kPsilMatrix,      sizeof(PsilMatrix),  false};
+static HeapPool VectorPool      = {"VECTOR",      kPsilVector,      sizeof(PsilVector),  false};
+static HeapPool HashTablePool   = {"HASHTABLE",   kPsilHashTable,   sizeof(PsilHashTable), false};
+static HeapPool EnvironmentPool = {"ENVIRONMENT", kPsilEnvironment, sizeof(Environment), true};
+
+static HeapPool *Pools[] = {&SymbolPool, &IntegerPool, &FlonumPool, &StringPool, &LongStringPool,
+                            &ConsPool, &FuncPool, &LambdaPool, &LocalPool, &CodePool,
+                            &CallSitePool, &BignumPool, &ArrayPool, &MatrixPool,
+                            &VectorPool, &HashTablePool, &EnvironmentPool, NULL};
+
+// The pool for each type.
+static HeapPool *TypePools[kNumPsilTypes];
+
+// Protected evaluator locals.
+static CellStack Roots;
+
+// Old cells which have had young objects stored into them.
+static CellStack Remembered;
+
+// Marked or promoted cells whose contents are yet to be scanned.
+static CellStack WorkList;
+
+// Code objects, long strings, bignums, arrays, matrices, vectors and hash tables,
+//  whose out-of-heap memory must be freed with them.
+static CellStack Finalizable;
+
+// Empty pages kept for reuse by the nursery.
+static HeapPage *SparePages = NULL;
+static long      NumSparePages = 0;
+
+static long NumYoungPages = 0;
+
+// Bytes in use in the old generation after the last full collection, and currently.
+static long BytesLive = 0;
+static long BytesInUse = 0;
+
+// Collect the old generation when the bytes in use reach this threshold.
+static long GCThreshold = kMinGCThreshold;
+
+// Maximum number of live bytes that may remain after a collection.
+long HeapLimit = kDefaultHeapLimit;
+
+// Has the allocator asked for a collection at the next safe point?
+bool GCRequested = false;
+
+// Incremented by every collection, since each one moves the young forms.
+unsigned long GCEpoch = 0;
+
+// Objects promoted by the current minor collection.
+static long ObjectsPromoted = 0;
+static long BytesPromoted = 0;
+
+static GCStatistics Statistics;
+
+
+// Define functions.
+
+
+static inline HeapPage *PageOf(void *cell)
+{
+    return (HeapPage *) ((uintptr_t) cell & ~(uintptr_t) (kPageSize - 1));
+}
+
+static inline int CellIndex(HeapPage *page, void *cell)
+{
+    return ((char *) cell - page->cells) / page->pool->cellSize;
+}
+
+static inline bool TestBit(unsigned long *bits, int index)
+{
+    return bits[index / kBitsPerWord] & (1UL << (index % kBitsPerWord));
+}
+
+static inline void SetBit(unsigned long *bits, int index)
+{
+    bits[index / kBitsPerWord] |= (1UL << (index % kBitsPerWord));
+}
+
+static inline void ClearBit(unsigned long *bits, int index)
+{
+    bits[index / kBitsPerWord] &= ~(1UL << (index % kBitsPerWord));
+}
+
+// (Fixnums are immediate, and so are not in the heap at all.)
+static inline bool IsHeapCell(void *cell)
+{
+    return cell && !IsFixnum((Form *) cell);
+}
+
+static inline bool IsYoung(void *cell)
+{
+    return IsHeapCell(cell) && PageOf(cell)->young;
+}
+
+static double ElapsedMilliseconds(struct timeval *start)
+{
+    struct timeval end;
+
+    gettimeofday(&end, NULL);
+
+    return (end.tv_sec - start->tv_sec) * 1000.0 + (end.tv_usec - start->tv_usec) / 1000.0;
+}
+
+static void PushCell(CellStack *stack, void *cell)
+{
+    if (stack->count >= stack->size) {
+        int size = stack->size ? 2 * stack->size : kInitialCellStackSize;
+        void **cells = (void **) realloc(stack->cells, size * sizeof(void *));
+        if (!cells)
+          ErrorOut("PushCell():  Failed to grow a heap stack to size %d!\n", size);
+        stack->cells = cells;
+        stack->size = size;
+    }
+
+    stack->cells[stack->count++] = cell;
+}
+
+static void FreeCellStack(CellStack *stack)
+{
+    free((void *) stack->cells);
+    stack->cells = NULL;
+    stack->size = stack->count = 0;
+}
+
+static HeapPage *NewPage(HeapPool *pool, bool young)
+{
+    HeapPage *page;
+    void *memory;
+
+    if (SparePages) {
+        page = SparePages;
+        SparePages = page->next;
+        NumSparePages--;
+    } else if (!posix_memalign(&memory, kPageSize, kPageSize))
+      page = (HeapPage *) memory;
+    else
+      return NULL;
+
+    page->header.type = pool->type;
+    page->pool = pool;
+    page->cells = (char *) page + ((sizeof(HeapPage) + kCellAlignment - 1) & ~(kCellAlignment - 1));
+    page->used = 0;
+    page->young = young;
+    memset(page->marks, 0, sizeof(page->marks));
+    memset(page->remembered, 0, sizeof(page->remembered));
+
+    return page;
+}
+
+static void ReleasePage(HeapPage *page)
+{
+    if (NumSparePages < kNurseryPages) {
+        page->next = SparePages;
+        SparePages = page;
+        NumSparePages++;
+    } else
+      free((void *) page);
+}
+
+static HeapPage *AddOldPage(HeapPool *pool)
+{
+    HeapPage *page;
+
+    if (!(page = NewPage(pool, false)))
+      return NULL;
+
+    // Thread the new cells onto the pool's free list, in address order.
+    for (int index = pool->cellsPerPage - 1; index >= 0; index--) {
+        void *cell = page->cells + index * pool->cellSize;
+        *(void **) cell = pool->freeList;
+        pool->freeList = cell;
+    }
+
+    page->next = pool->pages;
+    pool->pages = page;
+    pool->numPages++;
+
+    return page;
+}
+
+static HeapPage *AddYoungPage(HeapPool *pool)
+{
+    HeapPage *page;
+
+    if (!(page = NewPage(pool, true)))
+      return NULL;
+
+    page->next = pool->youngPages;
+    pool->youngPages = page;
+    pool->top = page->cells;
+    pool->limit = page->cells + pool->cellsPerPage * pool->cellSize;
+
+    if (++NumYoungPages >= kNurseryPages)
+      GCRequested = true;
+
+    return page;
+}
+
+static void *AllocateOldCell(HeapPool *pool)
+{
+    void *cell;
+
+    if (!pool->freeList && !AddOldPage(pool))
+      return NULL;
+
+    cell = pool->freeList;
+    pool->freeList = *(void **) cell;
+    PageOf(cell)->used++;
+
+    if ((BytesInUse += pool->cellSize) >= GCThreshold)
+      GCRequested = true;
+
+    return cell;
+}
+
+static void *AllocateCell(HeapPool *pool)
+{
+    void *cell;
+
+#ifdef GC_STRESS
+    GCRequested = true;
+#endif // GC_STRESS
+
+    if (!pool->hasNursery)
+      return AllocateOldCell(pool);
+
+    if (((size_t) (pool->limit - pool->top) < pool->cellSize) && !AddYoungPage(pool))
+      return NULL;
+
+    cell = pool->top;
+    pool->top += pool->cellSize;
+    PageOf(cell)->used++;
+
+    return cell;
+}
+
+int InitializeHeap(long heapLimit)
+{
+    HeapPool **pool;
+
+    for (pool = Pools; *pool; pool++) {
+        size_t header = (sizeof(HeapPage) + kCellAlignment - 1) & ~(kCellAlignment - 1);
+        if ((*pool)->cellSize < kMinCellSize)
+          (*pool)->cellSize = kMinCellSize;
+        (*pool)->cellSize = ((*pool)->cellSize + kMinCellSize - 1) & ~(kMinCellSize - 1);
+        (*pool)->cellsPerPage = (kPageSize - header) / (*pool)->cellSize;
+        if (*pool != &LongStringPool)
+          TypePools[(*pool)->type] = *pool;
+    }
+
+    HeapLimit = heapLimit;
+    GCThreshold = kMinGCThreshold;
+    GCRequested = false;
+
+    memset(&Statistics, 0, sizeof(Statistics));
+
+    return kPsilOK;
+}
+
+// Free the memory that a code object, long string, bignum, array, matrix, vector or hash table owns outside of the heap,
+//  returning how much of it was counted as in use.
+static long Finalize(Form *form)
+{
+    long bytes;
+
+    if (PageType(form) == kPsilString) {
+        bytes = form->value.string.length + 1;
+        free((void *) form->value.string.chars);
+        form->value.string.chars = NULL;
+        form->value.string.length = 0;
+        return bytes;
+    } else if (PageType(form) == kPsilBignum) {
+        bytes = form->value.bignum.length * sizeof(uint32_t);
+        free((void *) form->value.bignum.digits);
+        form->value.bignum.digits = NULL;
+        form->value.bignum.length = 0;
+        return bytes;
+    } else if (PageType(form) == kPsilArray) {
+        // (Both element types are 8 bytes.)
+        bytes = form->value.array.length * sizeof(double);
+        free(form->value.array.data);
+        form->value.array.data = NULL;
+        form->value.array.length = 0;
+        return bytes;
+    } else if (PageType(form) == kPsilMatrix) {
+        bytes = form->value.matrix.rows * form->value.matrix.columns * sizeof(double);
+        free((void *) form->value.matrix.data);
+        form->value.matrix.data = NULL;
+        form->value.matrix.rows = form->value.matrix.columns = 0;
+        return bytes;
+    } else if (PageType(form) == kPsilVector) {
+        bytes = form->value.vector.length * sizeof(Form *);
+        free((void *) form->value.vector.elements);
+        form->value.vector.elements = NULL;
+        form->value.vector.length = 0;
+        return bytes;
+    } else if (PageType(form) == kPsilHashTable) {
+        PsilHashTable *table = &form->value.hashTable;
+        bytes = (table->capacity + table->oldCapacity) * sizeof(PsilHashEntry);
+        free((void *) table->entries);
+        free((void *) table->oldEntries);
+        table->entries = table->oldEntries = NULL;
+        table->capacity = table->oldCapacity = table->used = table->count = 0;
+        return bytes;
+    }
+
+    free((void *) form->value.code.ops);
+    free((void *) form->value.code.constants);
+    form->value.code.ops = NULL;
+    form->value.code.constants = NULL;
+    form->value.code.numOps = form->value.code.numConstants = 0;
+
+    return 0;
+}
+
+static void FreePages(HeapPage *page)
+{
+    while (page) {
+        HeapPage *next = page->next;
+        free((void *) page);
+        page = next;
+    }
+}
+
+void DeInitializeHeap(void)
+{
+    HeapPool **pool;
+
+    for (int index = 0; index < Finalizable.count; index++)
+      Finalize((Form *) Finalizable.cells[index]);
+    FreeCellStack(&Finalizable);
+
+    for (pool = Pools; *pool; pool++) {
+        FreePages((*pool)->pages);
+        FreePages((*pool)->youngPages);
+        (*pool)->pages = (*pool)->youngPages = NULL;
+        (*pool)->freeList = NULL;
+        (*pool)->top = (*pool)->limit = NULL;
+        (*pool)->numPages = 0;
+    }
+
+    FreePages(SparePages);
+    SparePages = NULL;
+    NumSparePages = NumYoungPages = 0;
+
+    FreeCellStack(&Roots);
+    FreeCellStack(&Remembered);
+    FreeCellStack(&WorkList);
+
+    BytesInUse = BytesLive = 0;
+}
+
+Form *AllocateForm(PsilType type)
+{
+    HeapPool *pool = TypePools[type];
+    Form *form = pool ? (Form *) AllocateCell(pool) : NULL;
+
+    if (form && ((type == kPsilCode) || (type == kPsilBignum) || (type == kPsilArray)
+                 || (type == kPsilMatrix) || (type == kPsilVector) || (type == kPsilHashTable))) {
+        memset(form, 0, pool->cellSize);
+        PushCell(&Finalizable, form);
+    }
+
+    return form;
+}
+
+// Allocate a string in the old generation, to be finalized with its characters.
+Form *AllocateLongString(void)
+{
+    Form *form = (Form *) AllocateCell(&LongStringPool);
+
+    if (form) {
+        memset(form, 0, LongStringPool.cellSize);
+        PushCell(&Finalizable, form);
+    }
+
+    return form;
+}
+
+// Count memory allocated outside of the heap for an old object (i.e., a bignum's
+//  digits or the characters or elements of a long string, array, matrix,
+//  vector or hash table) as in use, so that it is taken into account in scheduling full collections.
+void AddExternalBytes(long bytes)
+{
+    if ((BytesInUse += bytes) >= GCThreshold)
+      GCRequested = true;
+}
+
+Environment *AllocateEnvironment(void)
+{
+    return (Environment *) AllocateCell(&EnvironmentPool);
+}
+
+int SaveRoots(void)
+{
+    return Roots.count;
+}
+
+void RestoreRoots(int rp)
+{
+    Roots.count = rp;
+}
+
+void ProtectForm(Form **form)
+{
+    PushCell(&Roots, (void *) form);
+}
+
+void ProtectEnvironment(Environment **env)
+{
+    PushCell(&Roots, (void *) env);
+}
+
+static void Remember(void *cell)
+{
+    HeapPage *page = PageOf(cell);
+    int index = CellIndex(page, cell);
+
+    if (!TestBit(page->remembered, index)) {
+        SetBit(page->remembered, index);
+        PushCell(&Remembered, cell);
+    }
+}
+
+bool IsYoungForm(Form *form)
+{
+    return IsYoung(form);
+}
+
+void WriteBarrier(Form *form, Form *value)
+{
+    if (IsYoung(value) && !IsYoung(form))
+      Remember(form);
+}
+
+void EnvironmentWriteBarrier(Environment *env, Form *value)
+{
+    if (IsYoung(value) && !IsYoung(env))
+      Remember(env);
+}
+
+// Apply the visitor to each heap pointer within the cell.
+static void ScanCell(void *cell, CellVisitor *visit)
+{
+    Form *form = (Form *) cell;
+
+    switch (PageType(cell)) {
+      case kPsilSymbol:
+          visit((void **) &form->value.symbol.value);
+          break;
+      case kPsilCons:
+          visit((void **) &form->value.list.car);
+          visit((void **) &form->value.list.cdr);
+          break;
+      case kPsilLambda:
+          visit((void **) &form->value.lambda.arglist);
+          visit((void **) &form->value.lambda.body);
+          visit((void **) &form->value.lambda.env);
+          visit((void **) &form->value.lambda.code);
+          break;
+      case kPsilLocal:
+          visit((void **) &form->value.local.symbol);
+          break;
+      case kPsilCode:
+          visit((void **) &form->value.code.arglist);
+          visit((void **) &form->value.code.body);
+          for (long index = 0; index < form->value.code.numConstants; index++)
+            visit((void **) &form->value.code.constants[index]);
+          break;
+      case kPsilVector:
+          for (long index = 0; index < form->value.vector.length; index++)
+            visit((void **) &form->value.vector.elements[index]);
+          break;
+      case kPsilHashTable:
+          for (long index = 0; index < form->value.hashTable.capacity; index++)
+            if (form->value.hashTable.entries[index].hash > kDeletedHash) {
+                visit((void **) &form->value.hashTable.entries[index].key);
+                visit((void **) &form->value.hashTable.entries[index].value);
+            }
+          for (long index = 0; index < form->value.hashTable.oldCapacity; index++)
+            if (form->value.hashTable.oldEntries[index].hash > kDeletedHash) {
+                visit((void **) &form->value.hashTable.oldEntries[index].key);
+                visit((void **) &form->value.hashTable.oldEntries[index].value);
+            }
+          break;
+      case kPsilCallSite:
+          visit((void **) &form->value.callSite.symbol);
+          visit((void **) &form->value.callSite.value);
+          break;
+      case kPsilEnvironment:
+          visit((void **) &((Environment *) cell)->value);
+          visit((void **) &((Environment *) cell)->parent);
+          break;
+      default:
+          break;
+    }
+}
+
+static void VisitRoots(CellVisitor *visit, FormVisitor *visitForm)
+{
+    visit((void **) &TopLevelEnv);
+    visit((void **) &CurrentEnv);
+
+    VisitStack(visitForm);
+    VisitSymbols(visitForm);
+
+    for (int rp = 0; rp < Roots.count; rp++)
+      visit((void **) Roots.cells[rp]);
+}
+
+// Minor collection.
+
+// Copy a young cell into the old generation, leaving a forwarding pointer behind.
+static void Evacuate(void **slot)
+{
+    void *cell = *slot;
+    HeapPage *page;
+    void *copy;
+    int index;
+
+    if (!IsHeapCell(cell) || !(page = PageOf(cell))->young)
+      return;
+
+    index = CellIndex(page, cell);
+
+    if (TestBit(page->marks, index)) {
+        *slot = *(void **) cell;
+        return;
+    }
+
+    if (!(copy = AllocateOldCell(page->pool)))
+      ErrorOut("Evacuate():  Failed to promote a cell of the %s pool!\n", page->pool->name);
+
+    memcpy(copy, cell, page->pool->cellSize);
+    SetBit(page->marks, index);
+    *(void **) cell = copy;
+    *slot = copy;
+
+    ObjectsPromoted++;
+    BytesPromoted += page->pool->cellSize;
+
+    PushCell(&WorkList, copy);
+}
+
+static void EvacuateForm(Form **form)
+{
+    Evacuate((void **) form);
+}
+
+// Returns the number of objects and bytes reclaimed from the nursery.
+static void MinorCollection(long *objects, long *bytes)
+{
+    HeapPool **pool;
+
+    *objects = *bytes = 0;
+    ObjectsPromoted = BytesPromoted = 0;
+
+    // (Pooled bindings are garbage, and the nursery is about to be reclaimed.)
+    FlushEnvironmentPool();
+
+    VisitRoots(Evacuate, EvacuateForm);
+
+    for (int index = 0; index < Remembered.count; index++) {
+        void *cell = Remembered.cells[index];
+        HeapPage *page = PageOf(cell);
+        ClearBit(page->remembered, CellIndex(page, cell));
+        ScanCell(cell, Evacuate);
+    }
+    Remembered.count = 0;
+
+    while (WorkList.count)
+      ScanCell(WorkList.cells[--WorkList.count], Evacuate);
+
+    // The nursery is now empty.
+    for (pool = Pools; *pool; pool++) {
+        HeapPage *page = (*pool)->youngPages;
+        while (page) {
+            HeapPage *next = page->next;
+            *objects += page->used;
+            *bytes += page->used * (*pool)->cellSize;
+#if DEBUG || defined(GC_POISON)
+            // POISON
+            memset(page->cells, 0xA5, (*pool)->cellsPerPage * (*pool)->cellSize);
+#endif // DEBUG || defined(GC_POISON)
+            ReleasePage(page);
+            page = next;
+        }
+        (*pool)->youngPages = NULL;
+        (*pool)->top = (*pool)->limit = NULL;
+    }
+    NumYoungPages = 0;
+
+    *objects -= ObjectsPromoted;
+    *bytes -= BytesPromoted;
+
+    GCEpoch++;
+    Statistics.minorCollections++;
+    Statistics.bytesPromoted += BytesPromoted;
+    Statistics.totalBytesReclaimed += *bytes;
+}
+
+// Full collection.
+
+static void MarkCell(void **slot)
+{
+    void *cell = *slot;
+    HeapPage *page;
+    int index;
+
+    if (!IsHeapCell(cell))
+      return;
+
+    page = PageOf(cell);
+    index = CellIndex(page, cell);
+
+    if (!TestBit(page->marks, index)) {
+        SetBit(page->marks, index);
+        PushCell(&WorkList, cell);
+    }
+}
+
+static void MarkForm(Form **form)
+{
+    MarkCell((void **) form);
+}
+
+// Rebuild the free list of the pool from its unmarked cells, releasing any empty pages.
+// Returns the number of cells reclaimed.
+static long SweepPool(HeapPool *pool)
+{
+    HeapPage **pagePtr = &pool->pages;
+    long reclaimed = 0;
+
+    pool->freeList = NULL;
+
+    while (*pagePtr) {
+        HeapPage *page = *pagePtr;
+        int used = 0;
+
+        for (int index = 0; index < pool->cellsPerPage; index++)
+          if (TestBit(page->marks, index))
+            used++;
+
+        reclaimed += page->used - used;
+
+        if (!used) {
+            *pagePtr = page->next;
+            pool->numPages--;
+            ReleasePage(page);
+            continue;
+        }
+
+        for (int index = pool->cellsPerPage - 1; index >= 0; index--)
+          if (!TestBit(page->marks, index)) {
+              void *cell = page->cells + index * pool->cellSize;
+#if DEBUG || defined(GC_POISON)
+              // POISON
+              memset(cell, 0xA5, pool->cellSize);
+#endif // DEBUG || defined(GC_POISON)
+              *(void **) cell = pool->freeList;
+              pool->freeList = cell;
+          }
+
+        page->used = used;
+        memset(page->marks, 0, sizeof(page->marks));
+        pagePtr = &page->next;
+    }
+
+    return reclaimed;
+}
+
+static long FullCollection(void)
+{
+    HeapPool **pool;
+    long objects, bytes, oldBytes = 0;
+
+    // Empty the nursery first, so only the old generation need be marked.
+    MinorCollection(&objects, &bytes);
+
+    VisitRoots(MarkCell, MarkForm);
+
+    while (WorkList.count)
+      ScanCell(WorkList.cells[--WorkList.count], MarkCell);
+
+    // Finalize the unmarked code objects and bignums before their cells are swept.
+    int count = 0;
+    for (int index = 0; index < Finalizable.count; index++) {
+        Form *form = (Form *) Finalizable.cells[index];
+        HeapPage *page = PageOf(form);
+        if (TestBit(page->marks, CellIndex(page, form)))
+          Finalizable.cells[count++] = form;
+        else
+          oldBytes += Finalize(form);
+    }
+    Finalizable.count = count;
+
+    for (pool = Pools; *pool; pool++) {
+        long reclaimed = SweepPool(*pool);
+        objects += reclaimed;
+        oldBytes += reclaimed * (*pool)->cellSize;
+    }
+
+    bytes += oldBytes;
+    BytesLive = BytesInUse -= oldBytes;
+    GCThreshold = 2 * BytesLive > kMinGCThreshold ? 2 * BytesLive : kMinGCThreshold;
+
+    Statistics.collections++;
+    Statistics.lastObjectsReclaimed = objects;
+    Statistics.lastBytesReclaimed = bytes;
+    Statistics.totalBytesReclaimed += oldBytes;
+
+    return bytes;
+}
+
+long CollectGarbage(void)
+{
+    struct timeval start;
+    long bytes;
+
+    gettimeofday(&start, NULL);
+
+    bytes = FullCollection();
+    GCRequested = false;
+
+    Statistics.lastMilliseconds = ElapsedMilliseconds(&start);
+    Statistics.totalMilliseconds += Statistics.lastMilliseconds;
+
+    return bytes;
+}
+
+void GCSafePoint(void)
+{
+    struct timeval start;
+    long objects, bytes;
+
+    if (BytesInUse < GCThreshold) {
+        gettimeofday(&start, NULL);
+        MinorCollection(&objects, &bytes);
+        Statistics.minorMilliseconds += ElapsedMilliseconds(&start);
+    }
+
+    // Promotion may itself have filled up the old generation.
+    if (BytesInUse >= GCThreshold) {
+        CollectGarbage();
+
+        if (HeapLimit && (BytesLive > HeapLimit))
+          ErrorForm("GCSafePoint():  Heap exhausted: %ld bytes live exceeds the heap limit of %ld bytes!\n",
+                    BytesLive, HeapLimit);
+    }
+
+    GCRequested = false;
+
+#ifdef GC_STRESS
+    // Also exercise the full collector now and then.
+    if (!(Statistics.minorCollections % 16))
+      CollectGarbage();
+#endif // GC_STRESS
+}
+
+void GetGCStatistics(GCStatistics *stats)
+{
+    *stats = Statistics;
+    stats->bytesInUse = BytesInUse;
+    stats->heapLimit = HeapLimit;
+    stats->numPages = NumYoungPages;
+    for (HeapPool **pool = Pools; *pool; pool++)
+      stats->numPages += (*pool)->numPages;
+    stats->pageSize = kPageSize;
+}
@@ -0,0 +1,430 @@
+/*
+    File:   Input.cpp
+    Author: ***PSI***
+    Date:   Mon Oct 19 03:36:52 2026
+
+    Description:
+       Psil reader input buffers.
+
+       The reader takes its characters from an input buffer, rather than
+       calling "fgetc()" (which locks the stream) for each one.  A regular
+       file is memory-mapped whole, so reading it is just indexing into the
+       mapping; a pipe or terminal is read with "read()" a large block at
+       a time (which returns a line at a time from a terminal); and a string
+       is read from a copy of its characters.
+
+       Only the reader may read from a stream given to it, since the
+       characters it has buffered are no longer in the stream.
+
+       The reader skips whitespace and comments, and finds the end of each
+       token, by scanning the buffered characters a block at a time, rather
+       than testing each against every delimiter.  The scanning kernels come
+       in scalar, SSE2 (16 characters at a time, by comparison with each
+       delimiter) and AVX2 (32 at a time, by looking up each character's
+       class by its two halves) versions, and the best one the processor
+       supports is selected the first time one is needed.  Comments are
+       skipped with "memchr()", which is already vectorized in the C library.
+
+       Define NO_SIMD to use the scalar kernels only.
+*/
+
+
+// Include declarations files.
+
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Psil.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(NO_SIMD)
+#define SIMD_KERNELS 1
+#include <immintrin.h>
+#else
+#define SIMD_KERNELS 0
+#endif // defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(NO_SIMD)
+
+
+// Define macros.
+
+
+// (The vector kernels are compiled for their instruction sets regardless of the compiler's target.)
+#define SSE2_KERNEL __attribute__((target("sse2")))
+#define AVX2_KERNEL __attribute__((target("avx2")))
+
+
+// Define constants.
+
+
+// The size of the blocks read from files which are not mapped.
+static const size_t kInputBlockSize = 1024 * 1024;
+
+// The classes of characters:  Whitespace, and the other characters which end a token.
+static const unsigned char kSpaceClass     = 1;
+static const unsigned char kDelimiterClass = 2;
+
+
+// Define types.
+
+
+typedef struct ScanKernels {
+    const char  *name;
+    // (Each returns the number of leading characters which are whitespace, or which are in a token.)
+    size_t      (*spaceLength)(const char *chars, size_t length);
+    size_t      (*tokenLength)(const char *chars, size_t length);
+} ScanKernels;
+
+
+// Define global variables.
+
+
+// The class of each character.
+static unsigned char CharClasses[256];
+
+
+// Define functions.
+
+
+static PsilInput *NewInput(void)
+{
+    PsilInput *input = (PsilInput *) calloc(1, sizeof(PsilInput));
+
+    if (!input)
+      ErrorOut("NewInput():  Failed to allocate an input!\n");
+
+    input->fd = -1;
+
+    return input;
+}
+
+// Map the rest of a regular file, returning false if it cannot be (e.g., it is not a regular file.)
+static bool MapInput(PsilInput *input)
+{
+    struct stat status;
+    off_t offset;
+
+    if ((fstat(input->fd, &status) < 0) || !S_ISREG(status.st_mode)
+        || ((offset = lseek(input->fd, 0, SEEK_CUR)) < 0) || (offset >= status.st_size))
+      return false;
+
+    void *mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, input->fd, 0);
+
+    if (mapping == MAP_FAILED)
+      return false;
+
+#ifdef MADV_SEQUENTIAL
+    madvise(mapping, status.st_size, MADV_SEQUENTIAL);
+#endif // MADV_SEQUENTIAL
+
+    // (Move the file to its end, as if it had all been read.)
+    lseek(input->fd, 0, SEEK_END);
+
+    input->mapping = mapping;
+    input->mappingLength = status.st_size;
+    input->chars = (const char *) mapping;
+    input->length = status.st_size;
+    input->position = offset;
+
+    return true;
+}
+
+PsilInput *OpenInputFile(FILE *file)
+{
+    PsilInput *input = NewInput();
+
+    input->file = file;
+    input->fd = fileno(file);
+
+    if (!MapInput(input)) {
+        if (!(input->buffer = (char *) malloc(kInputBlockSize)))
+          ErrorOut("OpenInputFile():  Failed to allocate the input buffer!\n");
+        input->bufferSize = kInputBlockSize;
+        input->chars = input->buffer;
+    }
+
+    return input;
+}
+
+PsilInput *OpenInputString(const char *chars, long length)
+{
+    PsilInput *input = NewInput();
+    char *copy = (char *) malloc(length + 1);
+
+    if (!copy)
+      ErrorOut("OpenInputString():  Failed to allocate %ld characters!\n", length);
+
+    memcpy(copy, chars, length);
+    copy[length] = '\0';
+
+    input->buffer = copy;
+    input->bufferSize = length + 1;
+    input->chars = copy;
+    input->length = length;
+
+    return input;
+}
+
+void CloseInput(PsilInput *input)
+{
+    if (!input)
+      return;
+
+    if (input->mapping)
+      munmap(input->mapping, input->mappingLength);
+    free((void *) input->buffer);
+    free((void *) input);
+}
+
+// Returns the next character after refilling the buffer, or EOF if there are no more.
+// (Mapped files and strings are already entirely available.)
+int FillInput(PsilInput *input)
+{
+    ssize_t count;
+
+    if (!input->file || input->mapping)
+      return EOF;
+
+    // (Retry reads interrupted by signals, e.g., by suspending and resuming the process.)
+    while (((count = read(input->fd, input->buffer, input->bufferSize)) < 0) && (errno == EINTR))
+      ;
+
+    if (count <= 0)
+      return EOF;
+
+    input->length = count;
+    input->position = 1;
+
+    return (unsigned char) input->chars[0];
+}
+
+// Scalar kernels:
+
+static void InitializeCharClasses(void)
+{
+    const char spaces[] = {kSpace, kTab, kReturn, kNewline};
+    const char delimiters[] = {kLeftParen, kRightParen, kQuote, kBackQuote, kAtSign, kColon, kDoubleQuote, kCommentChar};
+
+    for (size_t index = 0; index < sizeof(spaces); index++)
+      CharClasses[(unsigned char) spaces[index]] = kSpaceClass;
+    for (size_t index = 0; index < sizeof(delimiters); index++)
+      CharClasses[(unsigned char) delimiters[index]] = kDelimiterClass;
+}
+
+static size_t SpaceLength(const char *chars, size_t length)
+{
+    size_t i = 0;
+
+    while ((i < length) && (CharClasses[(unsigned char) chars[i]] == kSpaceClass))
+      i++;
+
+    return i;
+}
+
+static size_t TokenLength(const char *chars, size_t length)
+{
+    size_t i = 0;
+
+    while ((i < length) && !CharClasses[(unsigned char) chars[i]])
+      i++;
+
+    return i;
+}
+
+static const ScanKernels ScalarKernels = {"scalar", SpaceLength, TokenLength};
+
+#if SIMD_KERNELS
+
+// SSE2 kernels (16 characters):
+
+// Returns a mask of the whitespace characters.
+SSE2_KERNEL static inline __m128i SpacesSSE2(__m128i x)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(kSpace)), _mm_cmpeq_epi8(x, _mm_set1_epi8(kTab))),
+                        _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(kReturn)), _mm_cmpeq_epi8(x, _mm_set1_epi8(kNewline))));
+}
+
+SSE2_KERNEL static size_t SpaceLengthSSE2(const char *chars, size_t length)
+{
+    size_t i = 0;
+
+    for ( ; i + 16 <= length; i += 16) {
+        unsigned mask = ~_mm_movemask_epi8(SpacesSSE2(_mm_loadu_si128((const __m128i *) (chars + i)))) & 0xFFFF;
+        if (mask)
+          return i + __builtin_ctz(mask);
+    }
+
+    return i + SpaceLength(chars + i, length - i);
+}
+
+SSE2_KERNEL static size_t TokenLengthSSE2(const char *chars, size_t length)
+{
+    size_t i = 0;
+
+    for ( ; i + 16 <= length; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *) (chars + i));
+        __m128i delimiters =
+          _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(kLeftParen)),
+                                                 _mm_cmpeq_epi8(x, _mm_set1_epi8(kRightParen))),
+                                    _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(kQuote)),
+                                                 _mm_cmpeq_epi8(x, _mm_set1_epi8(kBackQuote)))),
+                       _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(kAtSign)),
+                                                 _mm_cmpeq_epi8(x, _mm_set1_epi8(kColon))),
+                                    _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(kDoubleQuote)),
+                                                 _mm_cmpeq_epi8(x, _mm_set1_epi8(kCommentChar)))));
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(delimiters, SpacesSSE2(x)));
+        if (mask)
+          return i + __builtin_ctz(mask);
+    }
+
+    return i + TokenLength(chars + i, length - i);
+}
+
+static const ScanKernels SSE2Kernels = {"SSE2", SpaceLengthSSE2, TokenLengthSSE2};
+
+// AVX2 kernels (32 characters):
+
+// Returns the classes of the characters, found by looking up each half of each character, and
+//  intersecting the sets of (sub)classes they may be in:
+//   1:  HT, LF or CR (high half 0; low half 9, A or D);
+//   2:  Space (2; 0);
+//   4:  '"', "'", '(' or ')' (2; 2, 7, 8 or 9);
+//   8:  ':' or ';' (3; A or B);
+//  16:  '@' or '`' (4 or 6; 0).
+// (So whitespace has class 1 or 2, and every other delimiter a higher one.)
+AVX2_KERNEL static inline __m256i ClassesAVX2(__m256i x)
+{
+    const __m256i lowClasses = _mm256_setr_epi8(2 | 16, 0, 4, 0, 0, 0, 0, 4, 4, 1 | 4, 1 | 8, 8, 0, 1, 0, 0,
+                                                2 | 16, 0, 4, 0, 0, 0, 0, 4, 4, 1 | 4, 1 | 8, 8, 0, 1, 0, 0);
+    const __m256i highClasses = _mm256_setr_epi8(1, 0, 2 | 4, 8, 16, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                 1, 0, 2 | 4, 8, 16, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    return _mm256_and_si256(_mm256_shuffle_epi8(lowClasses, _mm256_and_si256(x, nibble)),
+                            _mm256_shuffle_epi8(highClasses, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+}
+
+AVX2_KERNEL static size_t SpaceLengthAVX2(const char *chars, size_t length)
+{
+    const __m256i spaceClasses = _mm256_set1_epi8(1 | 2);
+    size_t i = 0;
+
+    for ( ; i + 32 <= length; i += 32) {
+        __m256i classes = ClassesAVX2(_mm256_loadu_si256((const __m256i *) (chars + i)));
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(classes, spaceClasses),
+                                                               _mm256_setzero_si256()));
+        if (mask)
+          return i + __builtin_ctz(mask);
+    }
+
+    return i + SpaceLengthSSE2(chars + i, length - i);
+}
+
+AVX2_KERNEL static size_t TokenLengthAVX2(const char *chars, size_t length)
+{
+    size_t i = 0;
+
+    for ( ; i + 32 <= length; i += 32) {
+        __m256i classes = ClassesAVX2(_mm256_loadu_si256((const __m256i *) (chars + i)));
+        unsigned mask = ~_mm256_movemask_epi8(_mm256_cmpeq_epi8(classes, _mm256_setzero_si256()));
+        if (mask)
+          return i + __builtin_ctz(mask);
+    }
+
+    return i + TokenLengthSSE2(chars + i, length - i);
+}
+
+static const ScanKernels AVX2Kernels = {"AVX2", SpaceLengthAVX2, TokenLengthAVX2};
+
+#endif // SIMD_KERNELS
+
+// Returns the best kernels the processor supports.
+static const ScanKernels *Kernels(void)
+{
+    static const ScanKernels *kernels = NULL;
+
+    if (!kernels) {
+        InitializeCharClasses();
+        kernels = &ScalarKernels;
+#if SIMD_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+          kernels = &AVX2Kernels;
+        else if (__builtin_cpu_supports("sse2"))
+          kernels = &SSE2Kernels;
+#endif // SIMD_KERNELS
+    }
+
+    return kernels;
+}
+
+// Returns the name of the scanning kernels in use.
+const char *ScanKernelsName(void)
+{
+    return Kernels()->name;
+}
+
+// Returns whether any characters remain, refilling the buffer if none are left in it.
+static bool InputAvailable(PsilInput *input)
+{
+    if (input->position < input->length)
+      return true;
+
+    if (FillInput(input) == EOF)
+      return false;
+
+    // (Put back the character "FillInput()" returned.)
+    input->position--;
+
+    return true;
+}
+
+// Advance the input past any whitespace and comments.
+void SkipInputSpace(PsilInput *input)
+{
+    const ScanKernels *kernels = Kernels();
+    bool inComment = false;
+
+    while (InputAvailable(input)) {
+        const char *chars = input->chars + input->position;
+        size_t available = input->length - input->position;
+
+        if (inComment) {
+            // (A comment runs through the next newline.)
+            const char *newline = (const char *) memchr(chars, kNewline, available);
+            if (!newline) {
+                input->position = input->length;
+                continue;
+            }
+            input->position += newline - chars + 1;
+            inComment = false;
+        } else {
+            size_t count = kernels->spaceLength(chars, available);
+            input->position += count;
+            if (count < available) {
+                if (chars[count] != kCommentChar)
+                  return;
+                input->position++;
+                inComment = true;
+            }
+        }
+    }
+}
+
+// Returns the number of characters of a token next in the input, which are at "*run" (and which
+//  are consumed.)  A token may continue in the next run, unless this one is empty.
+size_t InputTokenRun(PsilInput *input, const char **run)
+{
+    if (!InputAvailable(input))
+      return 0;
+
+    const char *chars = input->chars + input->position;
+    size_t count = Kernels()->tokenLength(chars, input->length - input->position);
+
+    *run = chars;
+    input->position += count;
+
+    return count;
+}
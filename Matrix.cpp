@@ -0,0 +1,353 @@
+/*
+    File:   Matrix.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 22:06:18 2026
+
+    Description:
+       Psil dense matrices.
+
+       A matrix holds its flonum elements unboxed, as "double"s, in one
+       contiguous block in row-major order, so referencing an element is
+       constant time, and whole-matrix operations run directly over the
+       elements without making any forms.  ("matrix-ref" returns its
+       element as a flonum, so it is rounded to a float unless
+       FLONUM_IS_DOUBLE is defined.)
+
+       Multiplication and transposition work on square tiles small enough
+       to stay in the cache, rather than striding through whole rows and
+       columns.  Large products are divided by rows of tiles among several
+       threads.  (The threads only touch the elements, never forms, so they
+       need no coordination with the garbage collector.)
+
+       Define NO_THREADS to multiply in the calling thread only.
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Psil.h"
+
+#ifndef NO_THREADS
+#include <pthread.h>
+#endif // !defined(NO_THREADS)
+
+
+// Define constants.
+
+
+// The side of the tiles multiplied at a time.
+// (Three 64x64 tiles of doubles are 96KB, which fits in a typical L2 cache.)
+static const long kTileSize = 64;
+
+// The side of the tiles transposed at a time.
+static const long kTransposeTileSize = 32;
+
+// Only multiply in parallel when the product takes at least this many multiply-adds.
+static const double kMinParallelWork = 8.0 * 1024 * 1024;
+
+static const int kMaxThreads = 16;
+
+
+// Define types.
+
+
+// The product of the rows [firstRow, lastRow) of a by b into c.
+typedef struct MultiplyTask {
+    const double *a;
+    const double *b;
+    double       *c;
+    long          firstRow;
+    long          lastRow;
+    long          inner;
+    long          columns;
+} MultiplyTask;
+
+
+// Define functions.
+
+
+// Returns a new matrix of zeros.
+static Form *NewMatrix(long rows, long columns)
+{
+    long size = rows * columns;
+    double *data = (double *) calloc(size ? size : 1, sizeof(double));
+    Form *form;
+
+    if (!data)
+      return ErrorForm("MakeMatrix():  Failed to allocate %ld x %ld elements!\n", rows, columns);
+
+    if ((form = AllocateForm(kPsilMatrix)) == NULL) {
+        free((void *) data);
+        return ErrorForm("MakeMatrix():  AllocateForm() failed!\n");
+    }
+
+    form->value.matrix.data = data;
+    form->value.matrix.rows = rows;
+    form->value.matrix.columns = columns;
+    AddExternalBytes(size * sizeof(double));
+
+    return form;
+}
+
+static bool IsDimension(Form *form)
+{
+    return IsInteger(form) && (IntegerValue(form) >= 0);
+}
+
+Form *MakeMatrix(Form *rows, Form *columns)
+{
+    if (!IsDimension(rows) || !IsDimension(columns))
+      return ErrorForm("MakeMatrix():  Dimensions must be non-negative integers!\n");
+    else if ((IntegerValue(columns) != 0) && (IntegerValue(rows) > (1L << 40) / IntegerValue(columns)))
+      return ErrorForm("MakeMatrix():  Too many elements!\n");
+
+    return NewMatrix((long) IntegerValue(rows), (long) IntegerValue(columns));
+}
+
+// Returns the index of the element, after checking that it is in bounds.
+static long ElementIndex(const char *name, Form *matrix, Form *row, Form *column)
+{
+    if (!IsMatrix(matrix)) {
+        ErrorForm("%s():  Non-matrix argument!\n", name);
+        return 0;
+    }
+
+    PsilMatrix *pmatrix = MatrixValue(matrix);
+
+    if (!IsInteger(row) || (IntegerValue(row) < 0) || (IntegerValue(row) >= pmatrix->rows)
+        || !IsInteger(column) || (IntegerValue(column) < 0) || (IntegerValue(column) >= pmatrix->columns)) {
+        ErrorForm("%s():  Index out of bounds (%ld x %ld)!\n", name, pmatrix->rows, pmatrix->columns);
+        return 0;
+    }
+
+    return (long) (IntegerValue(row) * pmatrix->columns + IntegerValue(column));
+}
+
+Form *MatrixRef(Form *matrix, Form *row, Form *column)
+{
+    long index = ElementIndex("MatrixRef", matrix, row, column);
+
+    return MakeFlonum(MatrixValue(matrix)->data[index]);
+}
+
+Form *MatrixSet(Form *matrix, Form *row, Form *column, Form *value)
+{
+    long index = ElementIndex("MatrixSet", matrix, row, column);
+
+    if (!IsNumber(value))
+      return ErrorForm("MatrixSet():  Non-numeric value!\n");
+
+    MatrixValue(matrix)->data[index] = NumberValue(value);
+
+    return value;
+}
+
+Form *MatrixRows(Form *matrix)
+{
+    if (!IsMatrix(matrix))
+      return ErrorForm("MatrixRows():  Non-matrix argument!\n");
+
+    return MakeInteger(MatrixValue(matrix)->rows);
+}
+
+Form *MatrixColumns(Form *matrix)
+{
+    if (!IsMatrix(matrix))
+      return ErrorForm("MatrixColumns():  Non-matrix argument!\n");
+
+    return MakeInteger(MatrixValue(matrix)->columns);
+}
+
+// Multiply the task's rows by tiles, accumulating into the (zeroed) product.
+// (The innermost loop runs along rows of b and c, so it is sequential and vectorizable.)
+static void *MultiplyRows(void *arg)
+{
+    MultiplyTask *task = (MultiplyTask *) arg;
+    const double *a = task->a, *b = task->b;
+    double *c = task->c;
+    long inner = task->inner, columns = task->columns;
+
+    for (long i0 = task->firstRow; i0 < task->lastRow; i0 += kTileSize) {
+        long i1 = (i0 + kTileSize < task->lastRow) ? (i0 + kTileSize) : task->lastRow;
+        for (long k0 = 0; k0 < inner; k0 += kTileSize) {
+            long k1 = (k0 + kTileSize < inner) ? (k0 + kTileSize) : inner;
+            for (long j0 = 0; j0 < columns; j0 += kTileSize) {
+                long j1 = (j0 + kTileSize < columns) ? (j0 + kTileSize) : columns;
+                for (long i = i0; i < i1; i++) {
+                    double *ci = c + i * columns;
+                    for (long k = k0; k < k1; k++) {
+                        double aik = a[i * inner + k];
+                        const double *bk = b + k * columns;
+                        for (long j = j0; j < j1; j++)
+                          ci[j] += aik * bk[j];
+                    }
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// Returns the number of threads to divide a product among.
+static int NumThreads(long rows, long inner, long columns)
+{
+#ifdef NO_THREADS
+    return 1;
+#else
+    if ((double) rows * inner * columns < kMinParallelWork)
+      return 1;
+
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    long tileRows = (rows + kTileSize - 1) / kTileSize;
+    long threads = (processors < tileRows) ? processors : tileRows;
+
+    return (threads < 1) ? 1 : (threads > kMaxThreads) ? kMaxThreads : (int) threads;
+#endif // NO_THREADS
+}
+
+Form *MatrixMultiply(Form *x, Form *y)
+{
+    if (!IsMatrix(x) || !IsMatrix(y))
+      return ErrorForm("MatrixMultiply():  Non-matrix argument(s)!\n");
+
+    PsilMatrix *px = MatrixValue(x), *py = MatrixValue(y);
+
+    if (px->columns != py->rows)
+      return ErrorForm("MatrixMultiply():  Incompatible dimensions: %ld x %ld times %ld x %ld!\n",
+                       px->rows, px->columns, py->rows, py->columns);
+
+    Form *result = NewMatrix(px->rows, py->columns);
+    MultiplyTask tasks[kMaxThreads];
+    int numThreads = NumThreads(px->rows, px->columns, py->columns);
+    // (Give each thread whole tiles of rows.)
+    long tileRows = (px->rows + kTileSize - 1) / kTileSize;
+
+    for (int index = 0; index < numThreads; index++) {
+        tasks[index].a = px->data;
+        tasks[index].b = py->data;
+        tasks[index].c = MatrixValue(result)->data;
+        tasks[index].firstRow = (tileRows * index / numThreads) * kTileSize;
+        tasks[index].lastRow = (tileRows * (index + 1) / numThreads) * kTileSize;
+        if (tasks[index].lastRow > px->rows)
+          tasks[index].lastRow = px->rows;
+        tasks[index].inner = px->columns;
+        tasks[index].columns = py->columns;
+    }
+
+#ifndef NO_THREADS
+    pthread_t threads[kMaxThreads];
+    int started = 1;
+
+    // (The calling thread does the first task, and any the others could not be started for.)
+    for ( ; started < numThreads; started++)
+      if (pthread_create(&threads[started], NULL, MultiplyRows, &tasks[started]))
+        break;
+
+    MultiplyRows(&tasks[0]);
+    for (int index = started; index < numThreads; index++)
+      MultiplyRows(&tasks[index]);
+
+    for (int index = 1; index < started; index++)
+      pthread_join(threads[index], NULL);
+#else
+    MultiplyRows(&tasks[0]);
+#endif // !defined(NO_THREADS)
+
+    return result;
+}
+
+Form *MatrixTranspose(Form *x)
+{
+    if (!IsMatrix(x))
+      return ErrorForm("MatrixTranspose():  Non-matrix argument!\n");
+
+    PsilMatrix *px = MatrixValue(x);
+    long rows = px->rows, columns = px->columns;
+    Form *result = NewMatrix(columns, rows);
+    const double *a = px->data;
+    double *t = MatrixValue(result)->data;
+
+    // (Transpose tile by tile, so that both the reads and the writes stay within a few cache lines.)
+    for (long i0 = 0; i0 < rows; i0 += kTransposeTileSize) {
+        long i1 = (i0 + kTransposeTileSize < rows) ? (i0 + kTransposeTileSize) : rows;
+        for (long j0 = 0; j0 < columns; j0 += kTransposeTileSize) {
+            long j1 = (j0 + kTransposeTileSize < columns) ? (j0 + kTransposeTileSize) : columns;
+            for (long i = i0; i < i1; i++)
+              for (long j = j0; j < j1; j++)
+                t[j * rows + i] = a[i * columns + j];
+        }
+    }
+
+    return result;
+}
+
+// Returns the element-wise sum (op '+'), difference ('-') or product ('*') of the matrices.
+static Form *ElementWise(const char *name, Form *x, Form *y, char op)
+{
+    if (!IsMatrix(x) || !IsMatrix(y))
+      return ErrorForm("%s():  Non-matrix argument(s)!\n", name);
+
+    PsilMatrix *px = MatrixValue(x), *py = MatrixValue(y);
+
+    if ((px->rows != py->rows) || (px->columns != py->columns))
+      return ErrorForm("%s():  Different dimensions: %ld x %ld and %ld x %ld!\n", name,
+                       px->rows, px->columns, py->rows, py->columns);
+
+    Form *result = NewMatrix(px->rows, px->columns);
+    const double *a = px->data, *b = py->data;
+    double *r = MatrixValue(result)->data;
+    long size = px->rows * px->columns;
+
+    switch (op) {
+      case '+':
+          for (long i = 0; i < size; i++)
+            r[i] = a[i] + b[i];
+          break;
+      case '-':
+          for (long i = 0; i < size; i++)
+            r[i] = a[i] - b[i];
+          break;
+      default:
+          for (long i = 0; i < size; i++)
+            r[i] = a[i] * b[i];
+    }
+
+    return result;
+}
+
+Form *MatrixAdd(Form *x, Form *y)
+{
+    return ElementWise("MatrixAdd", x, y, '+');
+}
+
+Form *MatrixSubtract(Form *x, Form *y)
+{
+    return ElementWise("MatrixSubtract", x, y, '-');
+}
+
+Form *MatrixElementMultiply(Form *x, Form *y)
+{
+    return ElementWise("MatrixElementMultiply", x, y, '*');
+}
+
+Form *MatrixScale(Form *x, Form *scale)
+{
+    if (!IsMatrix(x) || !IsNumber(scale))
+      return ErrorForm("MatrixScale():  Expected a matrix and a number!\n");
+
+    PsilMatrix *px = MatrixValue(x);
+    Form *result = NewMatrix(px->rows, px->columns);
+    const double *a = px->data;
+    double *r = MatrixValue(result)->data, s = NumberValue(scale);
+    long size = px->rows * px->columns;
+
+    for (long i = 0; i < size; i++)
+      r[i] = a[i] * s;
+
+    return result;
+}
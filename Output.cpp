@@ -0,0 +1,152 @@
+/*
+    File:   Output.cpp
+    Author: ***PSI***
+    Date:   Mon Oct 19 06:48:05 2026
+
+    Description:
+       Psil printer output buffers.
+
+       The printer appends the characters of a form to an output buffer,
+       rather than calling "fprintf()" (which parses its format, and locks
+       the stream) for each atom and separator.  The buffer is written to
+       the file in one piece when the form has been printed (or whenever
+       it fills), so other output to the file, such as the prompt and
+       newline of an interactive session, stays in order.
+
+       Integers are converted by hand, two digits at a time, directly into
+       the buffer.
+*/
+
+
+// Include declarations files.
+
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Psil.h"
+
+
+// Define constants.
+
+
+// The size of output buffers.
+static const size_t kOutputBufferSize = 64 * 1024;
+
+// The most characters of an integer (i.e., "-9223372036854775808".)
+static const size_t kMaxIntegerChars = 20;
+
+// The most characters written by "OutputFormat()".
+static const size_t kMaxFormatChars = 256;
+
+// The decimal digits of 0 through 99.
+static const char kDigitPairs[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+
+// Define functions.
+
+
+PsilOutput *OpenOutput(FILE *file)
+{
+    PsilOutput *output = (PsilOutput *) malloc(sizeof(PsilOutput));
+
+    if (!output || !(output->chars = (char *) malloc(kOutputBufferSize)))
+      ErrorOut("OpenOutput():  Failed to allocate an output buffer!\n");
+
+    output->file = file;
+    output->length = 0;
+    output->size = kOutputBufferSize;
+
+    return output;
+}
+
+void CloseOutput(PsilOutput *output)
+{
+    if (!output)
+      return;
+
+    FlushOutput(output);
+    free((void *) output->chars);
+    free((void *) output);
+}
+
+// Write the characters buffered to the file.
+// (They are not flushed from the file's own buffer, so, e.g., a terminal is still line buffered.)
+void FlushOutput(PsilOutput *output)
+{
+    if (output->length)
+      fwrite(output->chars, 1, output->length, output->file);
+    output->length = 0;
+}
+
+// Returns where to put up to "length" characters, which are then added by advancing the output's length.
+// (The length must be at most the size of the buffer.)
+char *ReserveOutput(PsilOutput *output, size_t length)
+{
+    if (output->length + length > output->size)
+      FlushOutput(output);
+
+    return output->chars + output->length;
+}
+
+void OutputChars(PsilOutput *output, const char *chars, size_t length)
+{
+    if (output->length + length > output->size) {
+        FlushOutput(output);
+        // (Write characters which would not fit in the buffer directly.)
+        if (length > output->size) {
+            fwrite(chars, 1, length, output->file);
+            return;
+        }
+    }
+
+    memcpy(output->chars + output->length, chars, length);
+    output->length += length;
+}
+
+void OutputString(PsilOutput *output, const char *string)
+{
+    OutputChars(output, string, strlen(string));
+}
+
+void OutputInteger(PsilOutput *output, PsilInteger integer)
+{
+    char digits[kMaxIntegerChars], *start = digits + kMaxIntegerChars;
+    // (The magnitude is computed unsigned, so that the most negative integer has one.)
+    uint64_t magnitude = (integer < 0) ? (0 - (uint64_t) integer) : (uint64_t) integer;
+
+    // Convert the digits from the right, two at a time.
+    while (magnitude >= 100) {
+        const char *pair = kDigitPairs + 2 * (magnitude % 100);
+        magnitude /= 100;
+        *--start = pair[1];
+        *--start = pair[0];
+    }
+    if (magnitude >= 10) {
+        *--start = kDigitPairs[2 * magnitude + 1];
+        *--start = kDigitPairs[2 * magnitude];
+    } else
+      *--start = '0' + (char) magnitude;
+    if (integer < 0)
+      *--start = kMinus;
+
+    OutputChars(output, start, digits + kMaxIntegerChars - start);
+}
+
+// Output formatted characters (e.g., a description of an unprintable form.)
+void OutputFormat(PsilOutput *output, const char *format, ...)
+{
+    char *chars = ReserveOutput(output, kMaxFormatChars);
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = vsnprintf(chars, kMaxFormatChars, format, args);
+    va_end(args);
+
+    if (length > 0)
+      output->length += ((size_t) length < kMaxFormatChars) ? length : (kMaxFormatChars - 1);
+}
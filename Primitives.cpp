@@ -19,6 +19,17 @@
 #include "Psil.h"
 
 
+// Define constants.
+
+
+// Flonums in [-2^63, 2^63) may be converted to integers.
+static const double kMinIntegerFlonum = -9223372036854775808.0;
+static const double kMaxIntegerFlonum = 9223372036854775808.0;
+
+// The depth of lists compared by "Equal()" before its stack is moved to the heap.
+static const long kLocalEqualDepth = 32;
+
+
 // Define macros.
 
 
@@ -36,6 +47,18 @@ bool TracePrimitives = false;
 // Define functions.
 
 
+// The type of a form, which must not be NULL.
+// (The types of heap forms are given by the pages they live on.)
+static inline PsilType FormType(Form *form)
+{
+    return IsFixnum(form) ? kPsilInteger : PageType(form);
+}
+
+static inline bool HasType(Form *form, PsilType type)
+{
+    return form && !IsFixnum(form) && (PageType(form) == type);
+}
+
 bool IsNull(Form *form)
 {
     return (form == SymbolNIL);
@@ -43,27 +66,32 @@ bool IsNull(Form *form)
 
 bool IsSymbol(Form *form)
 {
-    return (form && (form->type == kPsilSymbol));
+    return HasType(form, kPsilSymbol);
 }
 
 bool IsInteger(Form *form)
 {
-    return (form && (form->type == kPsilInteger));
+    return IsFixnum(form) || HasType(form, kPsilInteger);
+}
+
+bool IsBignum(Form *form)
+{
+    return HasType(form, kPsilBignum);
 }
 
 bool IsFlonum(Form *form)
 {
-    return (form && (form->type == kPsilFlonum));
+    return HasType(form, kPsilFlonum);
 }
 
 bool IsNumber(Form *form)
 {
-    return IsInteger(form) || IsFlonum(form);
+    return IsInteger(form) || IsBignum(form) || IsFlonum(form);
 }
 
 bool IsString(Form *form)
 {
-    return (form && (form->type == kPsilString));
+    return HasType(form, kPsilString);
 }
 
 bool IsAtom(Form *form)
@@ -73,17 +101,52 @@ bool IsAtom(Form *form)
 
 bool IsCons(Form *form)
 {
-    return (form && (form->type == kPsilCons));
+    return HasType(form, kPsilCons);
+}
+
+bool IsArray(Form *form)
+{
+    return HasType(form, kPsilArray);
+}
+
+bool IsMatrix(Form *form)
+{
+    return HasType(form, kPsilMatrix);
+}
+
+bool IsVector(Form *form)
+{
+    return HasType(form, kPsilVector);
+}
+
+bool IsHashTable(Form *form)
+{
+    return HasType(form, kPsilHashTable);
 }
 
 bool IsFunc(Form *form)
 {
-    return (form && (form->type == kPsilFunc));
+    return HasType(form, kPsilFunc);
 }
 
 bool IsClosure(Form *form)
 {
-    return (form && (form->type == kPsilLambda));
+    return HasType(form, kPsilLambda);
+}
+
+bool IsLocal(Form *form)
+{
+    return HasType(form, kPsilLocal);
+}
+
+bool IsCode(Form *form)
+{
+    return HasType(form, kPsilCode);
+}
+
+bool IsCallSite(Form *form)
+{
+    return HasType(form, kPsilCallSite);
 }
 
 bool IsLambda(Form *form)
@@ -91,9 +154,14 @@ bool IsLambda(Form *form)
     return form == SymbolLAMBDA;
 }
 
+bool IsResolvedLambda(Form *form)
+{
+    return form == SymbolResolvedLAMBDA;
+}
+
 bool IsLambdaForm(Form *form)
 {
-    return IsCons(form) && IsLambda(Car(form));
+    return IsCons(form) && (IsLambda(Car(form)) || IsResolvedLambda(Car(form)));
 }
 
 bool IsQuote(Form *form)
@@ -106,21 +174,22 @@ bool IsIf(Form *form)
     return form == SymbolIF;
 }
 
+// (The variable may have been resolved to a local.)
 bool IsAssignment(Form *form)
 {
-    return (Car(form) == SymbolSETQ) && IsSymbol(Cadr(form));
+    return (Car(form) == SymbolSETQ) && (IsSymbol(Cadr(form)) || IsLocal(Cadr(form)));
 }
 
 bool IsDefinition(Form *form)
 {
-    return (Car(form) == SymbolDEFINE) && IsSymbol(Cadr(form));
+    return (Car(form) == SymbolDEFINE) && (IsSymbol(Cadr(form)) || IsLocal(Cadr(form)));
 }
 
 const char *TypeOf(Form *form)
 {
     const char *type_str;
 
-    switch (form->type) {
+    switch (FormType(form)) {
       case kPsilNull:
           type_str = "NULL";
           break;
@@ -131,7 +200,10 @@ const char *TypeOf(Form *form)
           type_str = "SYMBOL";
           break;
       case kPsilInteger:
-          type_str = "FIXNUM";
+          type_str = IsFixnum(form) ? "FIXNUM" : "INTEGER";
+          break;
+      case kPsilBignum:
+          type_str = "BIGNUM";
           break;
       case kPsilFlonum:
           type_str = "FLONUM";
@@ -148,6 +220,27 @@ const char *TypeOf(Form *form)
       case kPsilLambda:
           type_str = "CLOSURE";
           break;
+      case kPsilArray:
+          type_str = "ARRAY";
+          break;
+      case kPsilMatrix:
+          type_str = "MATRIX";
+          break;
+      case kPsilVector:
+          type_str = "VECTOR";
+          break;
+      case kPsilHashTable:
+          type_str = "HASH-TABLE";
+          break;
+      case kPsilLocal:
+          type_str = "LOCAL";
+          break;
+      case kPsilCode:
+          type_str = "CODE";
+          break;
+      case kPsilCallSite:
+          type_str = "CALLSITE";
+          break;
       default:
           type_str = "UNKNOWN";
     }
@@ -157,22 +250,40 @@ const char *TypeOf(Form *form)
 
 int Length(Form *list)
 {
-    if (IsNull(list))
-      return 0;
-    else if (IsAtom(list)) {
+    int length = 0;
+
+    for ( ; IsCons(list); list = Cdr(list))
+      length++;
+
+    if (!IsNull(list)) {
         ErrorForm("Length():  Non-list type: %s\n", TypeOf(list));
         return 0;
-    } else
-      return 1 + Length(Cdr(list));
+    }
+
+    return length;
 }
 
 const char *SymbolName(Form *form)
 {
-    return form ? form->value.symbol->pname : "";
+    return form ? form->value.symbol.pname : "";
+}
+
+unsigned long SymbolHash(Form *form)
+{
+    return form ? form->value.symbol.hash : 0;
+}
+
+// Returns the global value of the symbol, or NULL if it is unbound.
+Form *SymbolValue(Form *form)
+{
+    return form ? form->value.symbol.value : NULL;
 }
 
-int IntegerValue(Form *form)
+PsilInteger IntegerValue(Form *form)
 {
+    if (IsFixnum(form))
+      return FixnumValue(form);
+
     return form ? form->value.integer : 0;
 }
 
@@ -188,6 +299,8 @@ double NumberValue(Form *form)
     if (form) {
         if (IsInteger(form))
           value = (double) IntegerValue(form);
+        else if (IsBignum(form))
+          value = BignumToDouble(form);
         else if (IsFlonum(form))
           value = FlonumValue(form);
         else
@@ -197,9 +310,18 @@ double NumberValue(Form *form)
     return value;
 }
 
+// N.B.:  A short string's characters move with it, so this is only valid until the next safe point.
 const char *StringValue(Form *form)
 {
-    return form ? form->value.string : "";
+    if (!form)
+      return "";
+
+    return (form->value.string.length < kShortStringSize) ? form->value.string.shortChars : form->value.string.chars;
+}
+
+long StringLength(Form *form)
+{
+    return form ? form->value.string.length : 0;
 }
 
 PsilFunc *FuncValue(Form *form)
@@ -209,22 +331,73 @@ PsilFunc *FuncValue(Form *form)
 
 Form *LambdaArglist(Form *form)
 {
-    return form ? form->value.lambda->arglist : NULL;
+    return form ? form->value.lambda.arglist : NULL;
 }
 
 Form *LambdaBody(Form *form)
 {
-    return form ? form->value.lambda->body : NULL;
+    return form ? form->value.lambda.body : NULL;
 }
 
 Environment *LambdaEnvironment(Form *form)
 {
-    return form ? form->value.lambda->env : NULL;
+    return form ? form->value.lambda.env : NULL;
+}
+
+Form *LambdaCode(Form *form)
+{
+    return form ? form->value.lambda.code : NULL;
+}
+
+PsilArray *ArrayValue(Form *form)
+{
+    return form ? &form->value.array : NULL;
+}
+
+PsilMatrix *MatrixValue(Form *form)
+{
+    return form ? &form->value.matrix : NULL;
+}
+
+PsilVector *VectorValue(Form *form)
+{
+    return form ? &form->value.vector : NULL;
+}
+
+PsilHashTable *HashTableValue(Form *form)
+{
+    return form ? &form->value.hashTable : NULL;
+}
+
+PsilCode *CodeValue(Form *form)
+{
+    return form ? &form->value.code : NULL;
+}
+
+Form *LocalSymbol(Form *form)
+{
+    return form ? form->value.local.symbol : NULL;
+}
+
+long LocalDepth(Form *form)
+{
+    return form ? form->value.local.depth : 0;
+}
+
+PsilCallSite *CallSiteValue(Form *form)
+{
+    return form ? &form->value.callSite : NULL;
 }
 
 bool Eq(Form *x, Form *y)
 {
-    return (x == y) || (IsInteger(x) && IsInteger(y) && (IntegerValue(x) == IntegerValue(y)));
+    // (Equal fixnums are the same form, but boxed integers and bignums must be compared by value.)
+    if ((x == y) || IsFixnum(x) || IsFixnum(y))
+      return (x == y);
+    else if (IsInteger(x) && IsInteger(y))
+      return (IntegerValue(x) == IntegerValue(y));
+    else
+      return IsBignum(x) && IsBignum(y) && !BignumCompare(x, y);
 }
 
 bool EqStr(Form *form, const char *string)
@@ -282,55 +455,32 @@ Form *Cadddr(Form *form)
     return Car(Cdr(Cdr(Cdr(form))));
 }
 
-Form *AllocateForm(void)
-{
-    return (Form *) malloc(sizeof(Form));
-}
-
-void DeallocateForm(Form *form)
-{
-    free((void *) form);
-}
-
-PsilSymbol *AllocateSymbol(void)
-{
-    return (PsilSymbol *) malloc(sizeof(PsilSymbol));
-}
-
-void DeallocateSymbol(PsilSymbol *symbol)
-{
-    free((void *) symbol);
-}
-
-Form *MakeSymbol(const char *pname)
+Form *MakeSymbol(const char *pname, unsigned long hash)
 {
     Form *form;
 
-    if ((form = AllocateForm()) == NULL)
+    if ((form = AllocateForm(kPsilSymbol)) == NULL)
       return ErrorForm("MakeSymbol():  AllocateForm() failed!\n");
 
-    form->type = kPsilSymbol;
-
-    if ((form->value.symbol = AllocateSymbol()) == NULL) {
-        DeallocateForm(form);
-        return ErrorForm("MakeSymbol():  AllocateSymbol() failed!\n");
-    }
-
-    form->value.symbol->pname = pname;
+    form->value.symbol.pname = pname;
+    form->value.symbol.value = NULL;
+    form->value.symbol.hash = hash;
 
     return form;
 }
 
-Form *MakeInteger(int integer)
+Form *MakeInteger(PsilInteger integer)
 {
     Form *form;
 
-    if ((form = AllocateForm()) == NULL) {
+    if ((integer <= kMostPositiveFixnum) && (integer >= kMostNegativeFixnum))
+      return FixnumForm((intptr_t) integer);
+
+    if ((form = AllocateForm(kPsilInteger)) == NULL) {
         Error("MakeInteger():  AllocateForm() failed!\n");
         return SymbolNIL;
     }
 
-    form->type = kPsilInteger;
     form->value.integer = integer;
 
     return form;
@@ -340,12 +490,11 @@ Form *MakeFlonum(double flonum)
 {
     Form *form;
 
-    if ((form = AllocateForm()) == NULL) {
+    if ((form = AllocateForm(kPsilFlonum)) == NULL) {
         Error("MakeFlonum():  AllocateForm() failed!\n");
         return SymbolNIL;
     }
 
-    form->type = kPsilFlonum;
     form->value.flonum = flonum;
 
     return form;
@@ -353,23 +502,43 @@ Form *MakeFlonum(double flonum)
 
 Form *MakeNumber(double number)
 {
-    if (number == (int) number)
-      return MakeInteger((int) number);
+    // (Only convert numbers in range, since converting others is undefined.)
+    if ((number >= kMinIntegerFlonum) && (number < kMaxIntegerFlonum) && (number == (PsilInteger) number))
+      return MakeInteger((PsilInteger) number);
     else
       return MakeFlonum(number);
 }
 
-Form *MakeString(const char *string)
+// Returns a new string of a copy of the characters, or of "length" NULs if "chars" is NULL.
+// (Short strings are young, and their characters inline; long strings are old.)
+Form *MakeString(const char *chars, long length)
 {
     Form *form;
-
-    if ((form = AllocateForm()) == NULL) {
-        Error("MakeString():  AllocateForm() failed!\n");
-        return SymbolNIL;
+    char *copy;
+
+    if (length < kShortStringSize) {
+        if ((form = AllocateForm(kPsilString)) == NULL) {
+            Error("MakeString():  AllocateForm() failed!\n");
+            return SymbolNIL;
+        }
+        copy = form->value.string.shortChars;
+    } else {
+        if ((copy = (char *) malloc(length + 1)) == NULL)
+          return ErrorForm("MakeString():  Failed to allocate %ld characters!\n", length);
+        if ((form = AllocateLongString()) == NULL) {
+            free((void *) copy);
+            return ErrorForm("MakeString():  AllocateLongString() failed!\n");
+        }
+        form->value.string.chars = copy;
+        AddExternalBytes(length + 1);
     }
 
-    form->type = kPsilString;
-    form->value.string = string;
+    form->value.string.length = length;
+    if (chars)
+      memcpy(copy, chars, length);
+    else
+      memset(copy, 0, length);
+    copy[length] = '\0';
 
     return form;
 }
@@ -378,48 +547,86 @@ Form *MakeFunc(PsilFunc *func)
 {
     Form *form;
 
-    if ((form = AllocateForm()) == NULL) {
+    if ((form = AllocateForm(kPsilFunc)) == NULL) {
         Error("MakeFunc():  AllocateForm() failed!\n");
         return SymbolNIL;
     }
 
-    form->type = kPsilFunc;
     form->value.func = func;
 
     return form;
 }
 
-PsilLambda *AllocateLambda(void)
+Form *MakeClosure(Form *arglist, Form *body, Environment *env)
 {
-    return (PsilLambda *) malloc(sizeof(PsilLambda));
+    Form *form;
+
+    if (TraceEvaluator) {
+        fprintf(StandardError, "\tMakeClosure()\n");
+    }
+
+    if ((form = AllocateForm(kPsilLambda)) == NULL)
+      return ErrorForm("MakeClosure():  AllocateForm() failed!\n");
+
+    // (The environment is now captured, so its bindings must not be reused.)
+    EnvironmentEpoch++;
+
+    form->value.lambda.arglist = arglist;
+    form->value.lambda.body = body;
+    form->value.lambda.env = env;
+    form->value.lambda.code = NULL;
+
+    return form;
 }
 
-void DeallocateLambda(PsilLambda *lambda)
+// Note:  The code takes ownership of the "malloc()"'d instructions and constants.
+Form *MakeCode(Form *arglist, Form *body, long *ops, long numOps, Form **constants, long numConstants)
 {
-    free((void *) lambda);
+    Form *form;
+
+    if ((form = AllocateForm(kPsilCode)) == NULL)
+      return ErrorForm("MakeCode():  AllocateForm() failed!\n");
+
+    form->value.code.arglist = arglist;
+    form->value.code.body = body;
+    form->value.code.ops = ops;
+    form->value.code.numOps = numOps;
+    form->value.code.constants = constants;
+    form->value.code.numConstants = numConstants;
+    form->value.code.threaded = false;
+
+    // (Code is allocated in the old generation, so remember any young forms it refers to.)
+    WriteBarrier(form, arglist);
+    WriteBarrier(form, body);
+    for (long index = 0; index < numConstants; index++)
+      WriteBarrier(form, constants[index]);
+
+    return form;
 }
 
-Form *MakeClosure(Form *arglist, Form *body, Environment *env)
+Form *MakeLocal(Form *symbol, long depth)
 {
     Form *form;
 
-    if (TraceEvaluator) {
-        fprintf(StandardError, "\tMakeClosure()\n");
-    }
+    if ((form = AllocateForm(kPsilLocal)) == NULL)
+      return ErrorForm("MakeLocal():  AllocateForm() failed!\n");
 
-    if ((form = AllocateForm()) == NULL)
-      return ErrorForm("MakeClosure():  AllocateForm() failed!\n");
+    form->value.local.symbol = symbol;
+    form->value.local.depth = depth;
+
+    return form;
+}
 
-    form->type = kPsilLambda;
+Form *MakeCallSite(Form *symbol)
+{
+    Form *form;
 
-    if ((form->value.lambda = AllocateLambda()) == NULL) {
-        DeallocateForm(form);
-        return ErrorForm("MakeClosure():  AllocateLambda() failed!\n");
-    }
+    if ((form = AllocateForm(kPsilCallSite)) == NULL)
+      return ErrorForm("MakeCallSite():  AllocateForm() failed!\n");
 
-    form->value.lambda->arglist = arglist;
-    form->value.lambda->body = body;
-    form->value.lambda->env = env;
+    form->value.callSite.symbol = symbol;
+    form->value.callSite.value = NULL;
+    form->value.callSite.version = 0;
 
     return form;
 }
@@ -428,24 +635,140 @@ Form *Cons(Form *car, Form *cdr)
 {
     Form *form;
 
-    if ((form = AllocateForm()) == NULL)
+    if ((form = AllocateForm(kPsilCons)) == NULL)
       return ErrorForm("Cons():  AllocateForm() failed!\n");
 
-    form->type = kPsilCons;
     form->value.list.car = car;
     form->value.list.cdr = cdr;
 
     return form;
 }
 
+Form *SetLambdaCode(Form *form, Form *code)
+{
+    if (!IsClosure(form))
+      return ErrorForm("SetLambdaCode():  Non-closure argument!\n");
+
+    form->value.lambda.code = code;
+    WriteBarrier(form, code);
+
+    return form;
+}
+
+Form *SetSymbolValue(Form *form, Form *value)
+{
+    if (!IsSymbol(form))
+      return ErrorForm("SetSymbolValue():  Non-symbol argument!\n");
+
+    form->value.symbol.value = value;
+    WriteBarrier(form, value);
+
+    // (Invalidate the call site caches.)
+    GlobalVersion++;
+
+    return value;
+}
+
+Form *SetCar(Form *form, Form *car)
+{
+    if (!IsCons(form))
+      return ErrorForm("SetCar():  Non-cons argument!\n");
+
+    form->value.list.car = car;
+    WriteBarrier(form, car);
+
+    return form;
+}
+
+Form *SetCdr(Form *form, Form *cdr)
+{
+    if (!IsCons(form))
+      return ErrorForm("SetCdr():  Non-cons argument!\n");
+
+    form->value.list.cdr = cdr;
+    WriteBarrier(form, cdr);
+
+    return form;
+}
+
 Form *Symbolp(Form *x)
 {
     return IsSymbol(x) ? SymbolT : SymbolNIL;
 }
 
+// Note:  The arithmetic primitives compute exactly with integers, promote
+//        to bignums when the integer result would overflow, and only fall
+//        back to (inexact) flonum arithmetic if an argument is a flonum.
+
+// Returns whether both forms are integers, and if so, their values.
+static inline bool IntegerValues(Form *x, Form *y, PsilInteger &i, PsilInteger &j)
+{
+    if (IsFixnum(x) && IsFixnum(y)) {
+        i = FixnumValue(x);
+        j = FixnumValue(y);
+        return true;
+    } else if (IsInteger(x) && IsInteger(y)) {
+        i = IntegerValue(x);
+        j = IntegerValue(y);
+        return true;
+    }
+
+    return false;
+}
+
+// Returns whether both forms are exact, i.e., integers or bignums.
+static inline bool AreExact(Form *x, Form *y)
+{
+    return (IsInteger(x) || IsBignum(x)) && (IsInteger(y) || IsBignum(y));
+}
+
+// These return whether the operation overflows, and if not, its result.
+// (The GCC builtins are used where available, since they compile to a flag test.)
+
+static inline bool AddOverflows(PsilInteger x, PsilInteger y, PsilInteger *result)
+{
+#if defined(__GNUC__)
+    return __builtin_add_overflow(x, y, result);
+#else
+    if (((y > 0) && (x > INT64_MAX - y)) || ((y < 0) && (x < INT64_MIN - y)))
+      return true;
+    *result = x + y;
+    return false;
+#endif // defined(__GNUC__)
+}
+
+static inline bool SubtractOverflows(PsilInteger x, PsilInteger y, PsilInteger *result)
+{
+#if defined(__GNUC__)
+    return __builtin_sub_overflow(x, y, result);
+#else
+    if (((y < 0) && (x > INT64_MAX + y)) || ((y > 0) && (x < INT64_MIN + y)))
+      return true;
+    *result = x - y;
+    return false;
+#endif // defined(__GNUC__)
+}
+
+static inline bool MultiplyOverflows(PsilInteger x, PsilInteger y, PsilInteger *result)
+{
+#if defined(__GNUC__)
+    return __builtin_mul_overflow(x, y, result);
+#else
+    if ((x > 0) ? ((y > 0) ? (x > INT64_MAX / y) : (y < INT64_MIN / x))
+                : ((y > 0) ? (x < INT64_MIN / y) : ((x != 0) && (y < INT64_MAX / x))))
+      return true;
+    *result = x * y;
+    return false;
+#endif // defined(__GNUC__)
+}
+
 Form *Zerop(Form *x)
 {
-    if (!IsNumber(x))
+    if (IsInteger(x))
+      return (IntegerValue(x) == 0) ? SymbolT : SymbolNIL;
+    else if (IsBignum(x))
+      return SymbolNIL;
+    else if (!IsNumber(x))
       return ErrorForm("Zerop():  Non-numeric argument!\n");
 
     return NumberValue(x) == 0.0 ? SymbolT : SymbolNIL;
@@ -453,100 +776,196 @@ Form *Zerop(Form *x)
 
 Form *NumberEqual(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j;
+
+    if (IntegerValues(x, y, i, j))
+      return (i == j) ? SymbolT : SymbolNIL;
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("NumberEqual():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return (BignumCompare(x, y) == 0) ? SymbolT : SymbolNIL;
 
     return NumberValue(x) == NumberValue(y) ? SymbolT : SymbolNIL;
 }
 
 Form *Less(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j;
+
+    if (IntegerValues(x, y, i, j))
+      return (i < j) ? SymbolT : SymbolNIL;
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Less():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return (BignumCompare(x, y) < 0) ? SymbolT : SymbolNIL;
 
     return NumberValue(x) < NumberValue(y) ? SymbolT : SymbolNIL;
 }
 
 Form *LessEqual(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j;
+
+    if (IntegerValues(x, y, i, j))
+      return (i <= j) ? SymbolT : SymbolNIL;
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("LessEqual():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return (BignumCompare(x, y) <= 0) ? SymbolT : SymbolNIL;
 
     return NumberValue(x) <= NumberValue(y) ? SymbolT : SymbolNIL;
 }
 
 Form *Greater(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j;
+
+    if (IntegerValues(x, y, i, j))
+      return (i > j) ? SymbolT : SymbolNIL;
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Greater():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return (BignumCompare(x, y) > 0) ? SymbolT : SymbolNIL;
 
     return NumberValue(x) > NumberValue(y) ? SymbolT : SymbolNIL;
 }
 
 Form *GreaterEqual(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j;
+
+    if (IntegerValues(x, y, i, j))
+      return (i >= j) ? SymbolT : SymbolNIL;
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("GreaterEqual():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return (BignumCompare(x, y) >= 0) ? SymbolT : SymbolNIL;
 
     return NumberValue(x) >= NumberValue(y) ? SymbolT : SymbolNIL;
 }
 
 Form *Plus(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j, k;
+
+    if (IntegerValues(x, y, i, j) && !AddOverflows(i, j, &k))
+      return MakeInteger(k);
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Plus():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return BignumAdd(x, y);
 
     return MakeNumber(NumberValue(x) + NumberValue(y));
 }
 
 Form *Minus(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j, k;
+
+    if (IntegerValues(x, y, i, j) && !SubtractOverflows(i, j, &k))
+      return MakeInteger(k);
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Minus():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return BignumSubtract(x, y);
 
     return MakeNumber(NumberValue(x) - NumberValue(y));
 }
 
 Form *Times(Form *x, Form *y)
 {
-    if (!IsNumber(x) || !IsNumber(y))
+    PsilInteger i, j, k;
+
+    if (IntegerValues(x, y, i, j) && !MultiplyOverflows(i, j, &k))
+      return MakeInteger(k);
+    else if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Times():  Non-numeric argument(s)!\n");
+    else if (AreExact(x, y))
+      return BignumMultiply(x, y);
 
     return MakeNumber(NumberValue(x) * NumberValue(y));
 }
 
 Form *Divide(Form *x, Form *y)
 {
+    PsilInteger i, j;
+
     if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Divide():  Non-numeric argument(s)!\n");
     else if (Zerop(y) == SymbolT)
       return ErrorForm("Divide():  Division by zero!\n");
 
+    // (Only an exact quotient is an integer, and the most negative integer over -1 overflows to a bignum.)
+    if (IntegerValues(x, y, i, j)) {
+        // (Check for the overflow first, since even taking the remainder traps.)
+        if ((j == -1) && (i == INT64_MIN))
+          return BignumSubtract(MakeInteger(0), x);
+        else if ((i % j) == 0)
+          return MakeInteger(i / j);
+    } else if (AreExact(x, y)) {
+        Form *remainder, *quotient = BignumDivide(x, y, &remainder);
+        if (Eq(remainder, MakeInteger(0)))
+          return quotient;
+    }
+
     return MakeNumber(NumberValue(x) / NumberValue(y));
 }
 
 Form *Remainder(Form *x, Form *y)
 {
+    PsilInteger i, j;
+
     if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Remainder():  Non-numeric argument(s)!\n");
-    else if (Zerop(y) == SymbolT)
+
+    // (Flonums are truncated to integers, or bignums if they are out of range, and the remainder taken exactly.)
+    if (!AreExact(x, y)) {
+        double a = NumberValue(x), b = NumberValue(y);
+        if (!isfinite(a) || !isfinite(b))
+          return MakeNumber(fmod(a, b));
+        if (IsFlonum(x))
+          x = DoubleToBignum(trunc(a));
+        if (IsFlonum(y))
+          y = DoubleToBignum(trunc(b));
+    }
+
+    if (Zerop(y) == SymbolT)
       return ErrorForm("Remainder():  Division by zero!\n");
 
-    return MakeInteger((int) NumberValue(x) % (int) NumberValue(y));
+    if (IntegerValues(x, y, i, j))
+      // (The remainder of the most negative integer over -1 overflows.)
+      return MakeInteger((j == -1) ? 0 : (i % j));
+
+    Form *remainder;
+    BignumDivide(x, y, &remainder);
+
+    return remainder;
 }
 
 Form *Add1(Form *x)
 {
-    if (!IsNumber(x))
+    PsilInteger k;
+
+    if (IsInteger(x) && !AddOverflows(IntegerValue(x), 1, &k))
+      return MakeInteger(k);
+    else if (!IsNumber(x))
       return ErrorForm("Add1():  Non-numeric argument!\n");
+    else if (IsInteger(x) || IsBignum(x))
+      return BignumAdd(x, MakeInteger(1));
 
     return MakeNumber(NumberValue(x) + 1);
 }
 
 Form *Sub1(Form *x)
 {
-    if (!IsNumber(x))
+    PsilInteger k;
+
+    if (IsInteger(x) && !SubtractOverflows(IntegerValue(x), 1, &k))
+      return MakeInteger(k);
+    else if (!IsNumber(x))
       return ErrorForm("Sub1():  Non-numeric argument!\n");
+    else if (IsInteger(x) || IsBignum(x))
+      return BignumSubtract(x, MakeInteger(1));
 
     return MakeNumber(NumberValue(x) - 1);
 }
@@ -577,9 +996,27 @@ Form *Log(Form *x, Form *y)
 
 Form *Expt(Form *x, Form *y)
 {
+    PsilInteger base, power, result = 1;
+
     if (!IsNumber(x) || !IsNumber(y))
       return ErrorForm("Expt():  Non-numeric argument(s)!\n");
 
+    // Raise an integer to a non-negative integer power by repeated squaring,
+    //  or if that overflows, a bignum.
+    if (IntegerValues(x, y, base, power) && (power >= 0)) {
+        PsilInteger remaining = power;
+        while (remaining) {
+            if ((remaining & 1) && MultiplyOverflows(result, base, &result))
+              break;
+            if ((remaining >>= 1) && MultiplyOverflows(base, base, &base))
+              break;
+        }
+        if (!remaining)
+          return MakeInteger(result);
+        return BignumExpt(x, power);
+    } else if (IsBignum(x) && IsInteger(y) && (IntegerValue(y) >= 0))
+      return BignumExpt(x, IntegerValue(y));
+
     return MakeNumber(pow(NumberValue(x), NumberValue(y)));
 }
 
@@ -607,19 +1044,68 @@ Form *Tangent(Form *x)
     return MakeNumber(tan(NumberValue(x)));
 }
 
-Form *Equal(Form *x, Form *y)
+// Are the forms, which are not both conses, equal?
+static bool EqualAtoms(Form *x, Form *y)
 {
     if (x == y)
-      return SymbolT;
+      return true;
     else if (IsAtom(x) && IsAtom(y))
       if (IsFlonum(x) && IsFlonum(y))
-        return NumberEqual(x, y);
+        return NumberEqual(x, y) == SymbolT;
+      else if (IsString(x) && IsString(y))
+        return StringEqual(x, y) == SymbolT;
       else
-        return (Eq(x, y) ? SymbolT : SymbolNIL);
-    else if (IsCons(x) && IsCons(y) && (Equal(Car(x), Car(y)) == SymbolT))
-      return Equal(Cdr(x), Cdr(y));
+        return Eq(x, y);
     else
-      return SymbolNIL;
+      return false;
+}
+
+// Compare the lists along their cdrs, and only descend into elements which are both lists,
+//  saving the rest of the lists on a stack, so that the stack grows with the lists' nesting
+//  depth rather than their length.
+Form *Equal(Form *x, Form *y)
+{
+    Form *localRests[2 * kLocalEqualDepth], **rests = localRests;
+    long depth = 0, size = kLocalEqualDepth;
+    bool equal = true;
+
+    for (;;) {
+        while (IsCons(x) && IsCons(y) && (x != y)) {
+            Form *a = Car(x), *b = Car(y);
+            x = Cdr(x);
+            y = Cdr(y);
+            if (IsCons(a) && IsCons(b) && (a != b)) {
+                if (depth == size) {
+                    Form **larger = (Form **) malloc(4 * size * sizeof(Form *));
+                    if (!larger)
+                      ErrorOut("Equal():  Failed to grow the stack to %ld lists!\n", 2 * size);
+                    memcpy(larger, rests, 2 * size * sizeof(Form *));
+                    if (rests != localRests)
+                      free((void *) rests);
+                    rests = larger;
+                    size *= 2;
+                }
+                rests[2 * depth] = x;
+                rests[2 * depth + 1] = y;
+                depth++;
+                x = a;
+                y = b;
+            } else if (!EqualAtoms(a, b)) {
+                equal = false;
+                break;
+            }
+        }
+        if (!equal || !(equal = EqualAtoms(x, y)) || (depth == 0))
+          break;
+        depth--;
+        x = rests[2 * depth];
+        y = rests[2 * depth + 1];
+    }
+
+    if (rests != localRests)
+      free((void *) rests);
+
+    return equal ? SymbolT : SymbolNIL;
 }
 
 Form *Set(Form *x, Form *y)
@@ -627,7 +1113,7 @@ Form *Set(Form *x, Form *y)
     if (!IsSymbol(x))
       return ErrorForm("Set():  Non-symbol first argument!\n");
     else {
-        CurrentEnv = SetBinding(SymbolName(x), y, CurrentEnv);
+        CurrentEnv = SetBinding(x, y, CurrentEnv);
         return y;
     }
 }
@@ -667,314 +1153,267 @@ Form *Exit(void)
     return SymbolNIL;
 }
 
-Form *FuncCar(void)
+// Call the primitive with its "nargs" arguments on the stack, popping them.
+Form *CallPrimitive(PsilFunc *pfunc, long nargs)
 {
-    Form *x = Pop();
+    Form *x, *y;
 
+    if (pfunc->funcN)
+      return (pfunc->funcN)(nargs);
+
+    switch (pfunc->nargs) {
+      case 1:
+          x = Pop();
+          return (pfunc->func1)(x);
+      case 2:
+          y = Pop();
+          x = Pop();
+          return (pfunc->func2)(x, y);
+      default:
+          return (pfunc->func)();
+    }
+}
+
+Form *FuncCar(Form *x)
+{
     TRACE_PRIM("Car");
 
     return Car(x);
 }
 
-Form *FuncCdr(void)
+Form *FuncCdr(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Cdr");
 
     return Cdr(x);
 }
 
-Form *FuncCons(void)
+Form *FuncCons(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Cons");
 
     return Cons(x, y);
 }
 
-Form *FuncAtom(void)
+Form *FuncRplaca(Form *x, Form *y)
+{
+    TRACE_PRIM("Rplaca");
+
+    return SetCar(x, y);
+}
+
+Form *FuncRplacd(Form *x, Form *y)
 {
-    Form *x = Pop();
+    TRACE_PRIM("Rplacd");
+
+    return SetCdr(x, y);
+}
 
+Form *FuncAtom(Form *x)
+{
     TRACE_PRIM("IsAtom");
 
     return IsAtom(x) ? SymbolT : SymbolNIL;
 }
 
-Form *FuncEq(void)
+Form *FuncEq(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Eq");
 
     return Eq(x, y) ? SymbolT : SymbolNIL;
 }
 
-Form *FuncNull(void)
+Form *FuncNull(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Null");
 
     return IsNull(x) ? SymbolT : SymbolNIL;
 }
 
-Form *FuncLength(void)
+Form *FuncLength(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Length");
 
-    return MakeNumber(Length(x));
+    return MakeInteger(Length(x));
 }
 
-Form *FuncTypeOf(void)
+Form *FuncTypeOf(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("TypeOf");
 
-    return MakeSymbol(TypeOf(x));
+    return MakeSymbol(TypeOf(x), 0);
 }
 
-Form *FuncSymbolp(void)
+Form *FuncSymbolp(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Symbolp");
 
     return Symbolp(x);
 }
 
-Form *FuncNumberp(void)
+Form *FuncNumberp(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Numberp");
 
     return IsNumber(x) ? SymbolT : SymbolNIL;
 }
 
-Form *FuncZerop(void)
+Form *FuncZerop(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Zerop");
 
     return Zerop(x);
 }
 
-Form *FuncNumberEqual(void)
+Form *FuncNumberEqual(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("NumberEqual");
 
     return NumberEqual(x, y);
 }
 
-Form *FuncLess(void)
+Form *FuncLess(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Less");
 
     return Less(x, y);
 }
 
-Form *FuncLessEqual(void)
+Form *FuncLessEqual(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("LessEqual");
 
     return LessEqual(x, y);
 }
 
-Form *FuncGreater(void)
+Form *FuncGreater(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Greater");
 
     return Greater(x, y);
 }
 
-Form *FuncGreaterEqual(void)
+Form *FuncGreaterEqual(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("GreaterEqual");
 
     return GreaterEqual(x, y);
 }
 
-Form *FuncPlus(void)
+Form *FuncPlus(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Plus");
 
     return Plus(x, y);
 }
 
-Form *FuncMinus(void)
+Form *FuncMinus(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Minus");
 
     return Minus(x, y);
 }
 
-Form *FuncTimes(void)
+Form *FuncTimes(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Times");
 
     return Times(x, y);
 }
 
-Form *FuncDivide(void)
+Form *FuncDivide(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Divide");
 
     return Divide(x, y);
 }
 
-Form *FuncRemainder(void)
+Form *FuncRemainder(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Remainder");
 
     return Remainder(x, y);
 }
 
-Form *FuncAdd1(void)
+Form *FuncAdd1(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Add1");
 
     return Add1(x);
 }
 
-Form *FuncSub1(void)
+Form *FuncSub1(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Sub1");
 
     return Sub1(x);
 }
 
-Form *FuncLn(void)
+Form *FuncLn(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Ln");
 
     return Ln(x);
 }
 
-Form *FuncExp(void)
+Form *FuncExp(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Exp");
 
     return Exp(x);
 }
 
-Form *FuncLog(void)
+Form *FuncLog(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Log");
 
     return Log(x, y);
 }
 
-Form *FuncExpt(void)
+Form *FuncExpt(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Expt");
 
     return Expt(x, y);
 }
 
-Form *FuncSin(void)
+Form *FuncSin(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Sin");
 
     return Sine(x);
 }
 
-Form *FuncCos(void)
+Form *FuncCos(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Cos");
 
     return Cosine(x);
 }
 
-Form *FuncTan(void)
+Form *FuncTan(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Tan");
 
     return Tangent(x);
 }
 
-Form *FuncEqual(void)
+Form *FuncEqual(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Equal");
 
     return Equal(x, y);
 }
 
-Form *FuncSet(void)
+Form *FuncSet(Form *x, Form *y)
 {
-    Form *y = Pop();
-    Form *x = Pop();
-
     TRACE_PRIM("Set");
 
     return Set(x, y);
 }
 
-Form *FuncTrace(void)
+Form *FuncTrace(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Trace");
 
     return Trace(x);
@@ -994,10 +1433,15 @@ Form *FuncRead(void)
     return Read(StandardInput);
 }
 
-Form *FuncEval(void)
+Form *FuncReadFromString(Form *x)
 {
-    Form *x = Pop();
+    TRACE_PRIM("ReadFromString");
 
+    return ReadFromString(x);
+}
+
+Form *FuncEval(Form *x)
+{
     TRACE_PRIM("Eval");
 
     // XXX -- Neither of these is quite right.  The intent of the "TopLevelEnv"
@@ -1011,11 +1455,8 @@ Form *FuncEval(void)
     return Eval(x, CurrentEnv);
 }
 
-Form *FuncApply(void)
+Form *FuncApply(Form *func, Form *args)
 {
-    Form *args = Pop();
-    Form *func = Pop();
-
     TRACE_PRIM("Apply");
 
     // XXX -- Neither of these is quite right. (See comments in "FuncEval()" above.)
@@ -1023,10 +1464,8 @@ Form *FuncApply(void)
     return Apply(func, args, CurrentEnv);
 }
 
-Form *FuncPrin1(void)
+Form *FuncPrin1(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Prin1");
 
     Print(x, StandardOutput);
@@ -1034,10 +1473,8 @@ Form *FuncPrin1(void)
     return x;
 }
 
-Form *FuncPrint(void)
+Form *FuncPrint(Form *x)
 {
-    Form *x = Pop();
-
     TRACE_PRIM("Print");
 
     fprintf(StandardOutput, "\n");
@@ -1046,3 +1483,350 @@ Form *FuncPrint(void)
 
     return x;
 }
+
+Form *FuncGC(void)
+{
+    TRACE_PRIM("GC");
+
+    return MakeInteger((PsilInteger) CollectGarbage());
+}
+
+Form *FuncMakeArray(Form *x, Form *y)
+{
+    TRACE_PRIM("MakeArray");
+
+    return MakeArray(x, y);
+}
+
+Form *FuncAref(Form *x, Form *y)
+{
+    TRACE_PRIM("Aref");
+
+    return ArrayRef(x, y);
+}
+
+Form *FuncAset(void)
+{
+    TRACE_PRIM("Aset");
+
+    Form *value = Pop(), *index = Pop(), *array = Pop();
+
+    return ArraySet(array, index, value);
+}
+
+Form *FuncArrayLength(Form *x)
+{
+    TRACE_PRIM("ArrayLength");
+
+    return ArrayLength(x);
+}
+
+Form *FuncArrayAdd(Form *x, Form *y)
+{
+    TRACE_PRIM("ArrayAdd");
+
+    return ArrayAdd(x, y);
+}
+
+Form *FuncArrayMultiply(Form *x, Form *y)
+{
+    TRACE_PRIM("ArrayMultiply");
+
+    return ArrayMultiply(x, y);
+}
+
+Form *FuncArrayDot(Form *x, Form *y)
+{
+    TRACE_PRIM("ArrayDot");
+
+    return ArrayDot(x, y);
+}
+
+Form *FuncArraySum(Form *x)
+{
+    TRACE_PRIM("ArraySum");
+
+    return ArraySum(x);
+}
+
+Form *FuncArrayMin(Form *x)
+{
+    TRACE_PRIM("ArrayMin");
+
+    return ArrayMin(x);
+}
+
+Form *FuncArrayMax(Form *x)
+{
+    TRACE_PRIM("ArrayMax");
+
+    return ArrayMax(x);
+}
+
+Form *FuncArraySin(Form *x)
+{
+    TRACE_PRIM("ArraySin");
+
+    return ArraySin(x);
+}
+
+Form *FuncArrayExp(Form *x)
+{
+    TRACE_PRIM("ArrayExp");
+
+    return ArrayExp(x);
+}
+
+Form *FuncArrayLn(Form *x)
+{
+    TRACE_PRIM("ArrayLn");
+
+    return ArrayLn(x);
+}
+
+Form *FuncMakeMatrix(Form *x, Form *y)
+{
+    TRACE_PRIM("MakeMatrix");
+
+    return MakeMatrix(x, y);
+}
+
+Form *FuncMatrixRef(void)
+{
+    TRACE_PRIM("MatrixRef");
+
+    Form *column = Pop(), *row = Pop(), *matrix = Pop();
+
+    return MatrixRef(matrix, row, column);
+}
+
+Form *FuncMatrixSet(void)
+{
+    TRACE_PRIM("MatrixSet");
+
+    Form *value = Pop(), *column = Pop(), *row = Pop(), *matrix = Pop();
+
+    return MatrixSet(matrix, row, column, value);
+}
+
+Form *FuncMatrixRows(Form *x)
+{
+    TRACE_PRIM("MatrixRows");
+
+    return MatrixRows(x);
+}
+
+Form *FuncMatrixColumns(Form *x)
+{
+    TRACE_PRIM("MatrixColumns");
+
+    return MatrixColumns(x);
+}
+
+Form *FuncMatmul(Form *x, Form *y)
+{
+    TRACE_PRIM("Matmul");
+
+    return MatrixMultiply(x, y);
+}
+
+Form *FuncTranspose(Form *x)
+{
+    TRACE_PRIM("Transpose");
+
+    return MatrixTranspose(x);
+}
+
+Form *FuncMatrixAdd(Form *x, Form *y)
+{
+    TRACE_PRIM("MatrixAdd");
+
+    return MatrixAdd(x, y);
+}
+
+Form *FuncMatrixSubtract(Form *x, Form *y)
+{
+    TRACE_PRIM("MatrixSubtract");
+
+    return MatrixSubtract(x, y);
+}
+
+Form *FuncMatrixMultiply(Form *x, Form *y)
+{
+    TRACE_PRIM("MatrixMultiply");
+
+    return MatrixElementMultiply(x, y);
+}
+
+Form *FuncMatrixScale(Form *x, Form *y)
+{
+    TRACE_PRIM("MatrixScale");
+
+    return MatrixScale(x, y);
+}
+
+Form *FuncVector(long nargs)
+{
+    TRACE_PRIM("Vector");
+
+    return PopVector(nargs);
+}
+
+Form *FuncMakeVector(long nargs)
+{
+    TRACE_PRIM("MakeVector");
+
+    if ((nargs < 1) || (nargs > 2)) {
+        RestoreStack(SaveStack() - nargs);
+        return ErrorForm("MakeVector():  Incorrect number of arguments: Supplied: %ld; Expected: 1 or 2\n", nargs);
+    }
+
+    Form *fill = (nargs == 2) ? Pop() : SymbolNIL, *length = Pop();
+
+    return MakeVector(length, fill);
+}
+
+Form *FuncVectorRef(Form *x, Form *y)
+{
+    TRACE_PRIM("VectorRef");
+
+    return VectorRef(x, y);
+}
+
+Form *FuncVectorSet(void)
+{
+    TRACE_PRIM("VectorSet");
+
+    Form *value = Pop(), *index = Pop(), *vector = Pop();
+
+    return VectorSet(vector, index, value);
+}
+
+Form *FuncVectorLength(Form *x)
+{
+    TRACE_PRIM("VectorLength");
+
+    return VectorLength(x);
+}
+
+Form *FuncListToVector(Form *x)
+{
+    TRACE_PRIM("ListToVector");
+
+    return ListToVector(x);
+}
+
+Form *FuncVectorToList(Form *x)
+{
+    TRACE_PRIM("VectorToList");
+
+    return VectorToList(x);
+}
+
+Form *FuncMakeHashTable(long nargs)
+{
+    TRACE_PRIM("MakeHashTable");
+
+    if (nargs > 1) {
+        RestoreStack(SaveStack() - nargs);
+        return ErrorForm("MakeHashTable():  Incorrect number of arguments: Supplied: %ld; Expected: 0 or 1\n", nargs);
+    }
+
+    return MakeHashTable(nargs ? Pop() : SymbolNIL);
+}
+
+Form *FuncGetHash(long nargs)
+{
+    TRACE_PRIM("GetHash");
+
+    if ((nargs < 2) || (nargs > 3)) {
+        RestoreStack(SaveStack() - nargs);
+        return ErrorForm("GetHash():  Incorrect number of arguments: Supplied: %ld; Expected: 2 or 3\n", nargs);
+    }
+
+    Form *missing = (nargs == 3) ? Pop() : SymbolNIL, *table = Pop(), *key = Pop();
+
+    return GetHash(key, table, missing);
+}
+
+Form *FuncPutHash(void)
+{
+    TRACE_PRIM("PutHash");
+
+    Form *table = Pop(), *value = Pop(), *key = Pop();
+
+    return PutHash(key, value, table);
+}
+
+Form *FuncRemHash(Form *x, Form *y)
+{
+    TRACE_PRIM("RemHash");
+
+    return RemHash(x, y);
+}
+
+Form *FuncMapHash(Form *x, Form *y)
+{
+    TRACE_PRIM("MapHash");
+
+    return MapHash(x, y);
+}
+
+Form *FuncHashTableCount(Form *x)
+{
+    TRACE_PRIM("HashTableCount");
+
+    return HashTableCount(x);
+}
+
+Form *FuncStringLength(Form *x)
+{
+    TRACE_PRIM("StringLength");
+
+    if (!IsString(x))
+      return ErrorForm("StringLength():  Non-string argument!\n");
+
+    return MakeInteger(StringLength(x));
+}
+
+Form *FuncSubstring(long nargs)
+{
+    TRACE_PRIM("Substring");
+
+    if ((nargs < 2) || (nargs > 3)) {
+        RestoreStack(SaveStack() - nargs);
+        return ErrorForm("Substring():  Incorrect number of arguments: Supplied: %ld; Expected: 2 or 3\n", nargs);
+    }
+
+    Form *end = (nargs == 3) ? Pop() : SymbolNIL, *start = Pop(), *string = Pop();
+
+    return Substring(string, start, end);
+}
+
+Form *FuncStringAppend(long nargs)
+{
+    TRACE_PRIM("StringAppend");
+
+    return StringAppend(nargs);
+}
+
+Form *FuncStringEqual(Form *x, Form *y)
+{
+    TRACE_PRIM("StringEqual");
+
+    return StringEqual(x, y);
+}
+
+Form *FuncStringSearch(long nargs)
+{
+    TRACE_PRIM("StringSearch");
+
+    if ((nargs < 2) || (nargs > 3)) {
+        RestoreStack(SaveStack() - nargs);
+        return ErrorForm("StringSearch():  Incorrect number of arguments: Supplied: %ld; Expected: 2 or 3\n", nargs);
+    }
+
+    Form *start = (nargs == 3) ? Pop() : SymbolNIL, *string = Pop(), *pattern = Pop();
+
+    return StringSearch(pattern, string, start);
+}
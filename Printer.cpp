@@ -13,75 +13,290 @@
 // Include declarations files.
 
 
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <charconv>
 #include "Psil.h"
 
 
+// Define constants.
+
+
+// The depth of lists, vectors and closures printed before the printer's stack is moved to the heap.
+static const long kLocalPrintFrames = 32;
+
+// Enough characters for any integer or flonum (e.g., "-1.7976931348623157e+308".)
+static const int kMaxNumberChars = 32;
+
+
+// Define types.
+
+
+// What a frame is printing.
+typedef enum PrintKind {
+    kPrintList,
+    kPrintVector,
+    kPrintClosure,
+    // (The environment of a closure, once its body has been printed.)
+    kPrintEnvironment
+} PrintKind;
+
+// A list, vector or closure being printed.
+typedef struct PrintFrame {
+    PrintKind    kind;
+    // (The vector or closure.)
+    Form        *form;
+    // (The rest of the list, or of the closure's body.)
+    Form        *rest;
+    // (The next binding of the environment to print.)
+    Environment *env;
+    // (The number of elements printed, or of bindings begun for an environment.)
+    long         index;
+} PrintFrame;
+
+
+// Define global variables.
+
+
+// The printer's output buffer.
+static PsilOutput *Output = NULL;
+
+
 // Define functions.
 
 
-int PrintList(Form *form, FILE *outstream)
+// Returns the printer's output buffer, writing to the file.
+static PsilOutput *OutputTo(FILE *outstream)
 {
-    Form *car = Car(form);
-    Form *cdr = Cdr(form);
+    if (!Output)
+      Output = OpenOutput(outstream);
+    else if (Output->file != outstream) {
+        FlushOutput(Output);
+        Output->file = outstream;
+    }
 
-    fprintf(outstream, " ");
+    return Output;
+}
 
-    Print(car, outstream);
+// Print the string in double quotes, escaping characters as the reader expects them.
+static void PrintString(Form *form, PsilOutput *output)
+{
+    const char *chars = StringValue(form);
+    long length = StringLength(form), start = 0;
 
-    if (IsAtom(cdr) && !IsNull(cdr)) {
-        fprintf(outstream, " . ");
-        Print(cdr, outstream);
-    } else if (!IsNull(cdr))
-      PrintList(cdr, outstream);
+    OutputChar(output, kDoubleQuote);
 
-    return kPsilOK;
+    for (long index = 0; index < length; index++) {
+        unsigned char c = chars[index];
+        if ((c >= ' ') && (c != kDoubleQuote) && (c != kBackSlash) && (c != 0x7F))
+          continue;
+        // (Output the plain characters before this one all at once.)
+        OutputChars(output, chars + start, index - start);
+        start = index + 1;
+        switch (c) {
+          case '\n':  OutputString(output, "\\n");  break;
+          case '\t':  OutputString(output, "\\t");  break;
+          case '\r':  OutputString(output, "\\r");  break;
+          case kDoubleQuote:
+          case kBackSlash:
+              OutputChar(output, kBackSlash);
+              OutputChar(output, c);
+              break;
+          default:
+              OutputFormat(output, "\\x%02X", c);
+        }
+    }
+
+    OutputChars(output, chars + start, length - start);
+    OutputChar(output, kDoubleQuote);
 }
 
-int Print(Form *form, FILE *outstream)
+// Print the flonum in the fewest digits which read back as the same flonum.
+// (Integral flonums are given a decimal point, since otherwise they would read back as integers.)
+static void PrintFlonum(PsilFlonum flonum, PsilOutput *output)
+{
+    char *chars = ReserveOutput(output, kMaxNumberChars);
+    char *end = std::to_chars(chars, chars + kMaxNumberChars - 2, flonum).ptr;
+
+    if (isfinite(flonum) && !memchr(chars, kPoint, end - chars) && !memchr(chars, 'e', end - chars)) {
+        *end++ = kPoint;
+        *end++ = '0';
+    }
+
+    output->length += end - chars;
+}
+
+// Print a form other than a list, vector or closure.
+static int PrintAtom(Form *form, PsilOutput *output)
 {
     if (IsNull(form)) {
-        fprintf(outstream, "NIL");
+        OutputString(output, "NIL");
     } else if (IsSymbol(form)) {
-        fprintf(outstream, "%s", SymbolName(form));
+        OutputString(output, SymbolName(form));
+    } else if (IsLocal(form)) {
+        OutputString(output, SymbolName(LocalSymbol(form)));
+    } else if (IsCallSite(form)) {
+        OutputString(output, SymbolName(CallSiteValue(form)->symbol));
     } else if (IsInteger(form)) {
-        fprintf(outstream, "%d", IntegerValue(form));
+        OutputInteger(output, IntegerValue(form));
+    } else if (IsBignum(form)) {
+        char *digits = BignumToString(form);
+        OutputString(output, digits);
+        free((void *) digits);
     } else if (IsFlonum(form)) {
-        fprintf(outstream, "%f", FlonumValue(form));
+        PrintFlonum((PsilFlonum) FlonumValue(form), output);
     } else if (IsString(form)) {
-        fprintf(outstream, "\"%s\"", StringValue(form));
-    } else if (IsClosure(form)) {
-        fprintf(outstream, "#<(LAMBDA ");
-        Print(LambdaArglist(form), outstream);
-        fprintf(outstream, " ");
-        Form *lambdaBody = LambdaBody(form);
-        while (!IsNull(lambdaBody)) {
-            Print(Car(lambdaBody), outstream);
-            lambdaBody = Cdr(lambdaBody);
-        }
-        fprintf(outstream, ") ");
-        PrintEnvironment(LambdaEnvironment(form), outstream, TraceEnvironment);
-        fprintf(outstream, ">");
-    } else if (IsCons(form)) {
-        fprintf(outstream, "(");
-        Print(Car(form), outstream);
-        Form *cdr = Cdr(form);
-        if (IsNull(cdr))
-          fprintf(outstream, ")");
-        else if (!IsCons(cdr)) {
-            fprintf(outstream, " . ");
-            Print(cdr, outstream);
-            fprintf(outstream, ")");
-        } else {
-            PrintList(cdr, outstream);
-            fprintf(outstream, ")");
-        }
-    } else if (IsString(form)) {
-        fprintf(outstream, "\"%s\"", StringValue(form));
+        PrintString(form, output);
+    } else if (IsArray(form)) {
+        PsilArray *array = ArrayValue(form);
+        OutputFormat(output, "#<Array %s length:%ld>", (array->elementType == kPsilF64) ? "F64" : "I64", array->length);
+    } else if (IsMatrix(form)) {
+        PsilMatrix *matrix = MatrixValue(form);
+        OutputFormat(output, "#<Matrix %ldx%ld>", matrix->rows, matrix->columns);
+    } else if (IsHashTable(form)) {
+        PsilHashTable *table = HashTableValue(form);
+        OutputFormat(output, "#<HashTable %s count:%ld>", (table->test == kPsilHashEq) ? "EQ" : "EQUAL", table->count);
+    } else if (IsCode(form)) {
+        OutputFormat(output, "#<Code %ld ops>", CodeValue(form)->numOps);
     } else if (IsFunc(form)) {
         PsilFunc *func = FuncValue(form);
-        fprintf(outstream, "#<Func %s nargs:%d>", func->name, func->nargs);
+        OutputFormat(output, "#<Func %s nargs:%d>", func->name, func->nargs);
     } else
       return Error("Print():  Invalid form type!\n");
 
     return kPsilOK;
 }
+
+// Print a form, keeping the lists, vectors and closures being printed on a stack, rather
+//  than recursing, so that lists may be as long, and nested as deeply, as memory allows.
+int Print(Form *form, FILE *outstream)
+{
+    PsilOutput *output = OutputTo(outstream);
+    PrintFrame localFrames[kLocalPrintFrames], *frames = localFrames;
+    long depth = 0, size = kLocalPrintFrames;
+    int status = kPsilOK;
+    bool next = true;
+
+    while (next) {
+        // Begin printing a list, vector or closure, or print anything else.
+        if (IsCons(form) || IsVector(form) || IsClosure(form)) {
+            if (depth == size) {
+                PrintFrame *larger = (PrintFrame *) malloc(2 * size * sizeof(PrintFrame));
+                if (!larger)
+                  ErrorOut("Print():  Failed to grow the printer stack to %ld frames!\n", 2 * size);
+                memcpy(larger, frames, size * sizeof(PrintFrame));
+                if (frames != localFrames)
+                  free((void *) frames);
+                frames = larger;
+                size *= 2;
+            }
+            if (IsClosure(form)) {
+                OutputString(output, "#<(LAMBDA ");
+                frames[depth].kind = kPrintClosure;
+                frames[depth].rest = LambdaBody(form);
+            } else {
+                if (IsVector(form))
+                  OutputChar(output, kSharp);
+                OutputChar(output, kLeftParen);
+                frames[depth].kind = IsVector(form) ? kPrintVector : kPrintList;
+                frames[depth].rest = form;
+            }
+            frames[depth].form = form;
+            frames[depth].env = NULL;
+            frames[depth].index = 0;
+            depth++;
+        } else if (PrintAtom(form, output) != kPsilOK)
+          status = kPsilError;
+
+        // Find the next element to print, ending the lists, vectors and closures finished.
+        for (next = false; !next && (depth > 0); ) {
+            PrintFrame *frame = &frames[depth - 1];
+            if (frame->kind == kPrintVector) {
+                PsilVector *vector = VectorValue(frame->form);
+                if (frame->index < vector->length) {
+                    if (frame->index)
+                      OutputChar(output, kSpace);
+                    form = vector->elements[frame->index++];
+                    next = true;
+                }
+            } else if (frame->kind == kPrintClosure) {
+                // (The arglist, then the body forms, which are not separated.)
+                if (frame->index++ == 0) {
+                    form = LambdaArglist(frame->form);
+                    next = true;
+                } else {
+                    if (frame->index == 2)
+                      OutputChar(output, kSpace);
+                    if (!IsNull(frame->rest)) {
+                        form = Car(frame->rest);
+                        frame->rest = Cdr(frame->rest);
+                        next = true;
+                    } else {
+                        OutputChar(output, kRightParen);
+                        // (Closures made at top level have no environment, since globals are in symbols.)
+                        if (LambdaEnvironment(frame->form)) {
+                            OutputChar(output, kSpace);
+                            frame->kind = kPrintEnvironment;
+                            frame->env = LambdaEnvironment(frame->form);
+                            frame->index = 0;
+                        } else {
+                            OutputChar(output, '>');
+                            depth--;
+                        }
+                    }
+                }
+                continue;
+            } else if (frame->kind == kPrintEnvironment) {
+                // (As "PrintEnvironment()" does:  Every binding when tracing environments, otherwise just the first.)
+                if (TraceEnvironment && frame->index)
+                  OutputString(output, "] ");
+                if (frame->env) {
+                    Environment *env = frame->env;
+                    OutputFormat(output, "#<ENV %p", (void *) env);
+                    if (TraceEnvironment) {
+                        if (env == TopLevelEnv)
+                          OutputString(output, ": TOP-LEVEL");
+                        else if (env == CurrentEnv)
+                          OutputString(output, ": CURRENT");
+                        OutputFormat(output, ": [\"%s\", ", env->name);
+                        form = env->value;
+                        frame->env = env->parent;
+                        next = true;
+                    } else
+                      frame->env = NULL;
+                    frame->index++;
+                } else {
+                    // (End each binding begun, and then the closure.)
+                    for (long index = 0; index <= frame->index; index++)
+                      OutputChar(output, '>');
+                    depth--;
+                }
+                continue;
+            } else if (IsCons(frame->rest)) {
+                if (frame->index++)
+                  OutputChar(output, kSpace);
+                form = Car(frame->rest);
+                frame->rest = Cdr(frame->rest);
+                next = true;
+            } else if (!IsNull(frame->rest)) {
+                OutputString(output, " . ");
+                form = frame->rest;
+                frame->rest = SymbolNIL;
+                next = true;
+            }
+            if (!next) {
+                OutputChar(output, kRightParen);
+                depth--;
+            }
+        }
+    }
+
+    if (frames != localFrames)
+      free((void *) frames);
+
+    // (The form has been printed, so write it to the file.)
+    FlushOutput(output);
+
+    return status;
+}
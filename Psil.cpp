@@ -13,6 +13,7 @@
 // Include declarations files.
 
 
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include "Psil.h"
@@ -44,6 +45,9 @@ int ParseFile(char *filename)
 {
     int status = kPsilOK;
 
+    if (InitializeHeap(HeapLimit) != kPsilOK)
+      return Error("ParseFile(\"%s\"):  InitializeHeap() failed!\n", filename);
+
     if (InitializeReader() != kPsilOK)
       return Error("ParseFile(\"%s\"):  InitializeReader() failed!\n");
 
@@ -52,14 +56,15 @@ int ParseFile(char *filename)
     if (InitializeStack() != kPsilOK)
       return Error("ParseFile(\"%s\"):  InitializeStack() failed!\n");
 
+    // (Set up the output streams first, so that an error opening the file can be reported.)
+    StandardOutput = stdout;
+    StandardError  = stderr;
+
     if (!strcmp(filename, "-"))
       StandardInput = stdin;
     else if ((StandardInput = fopen(filename, "r")) == NULL)
       return Error("ParseFile(\"%s\"):  Failed fopen()!\n", filename);
 
-    StandardOutput = stdout;
-    StandardError  = stderr;
-
     CurrentEnv = TopLevelEnv = env;
 
     InterpreterRunning = true;
@@ -68,16 +73,19 @@ int ParseFile(char *filename)
       Message(";;; Welcome to Psil v%s!\n", kPsilVersion);
 
     while (InterpreterRunning && FileIsOpen(StandardInput)) {
-        int retval, stackPtr = SaveStack();
+        int retval, stackPtr = SaveStack(), rootPtr = SaveRoots();
         if (IsInteractive)
           Message("==> ");
         if (!(retval = setjmp(TopLevelJmpBuf))) {
-            status = Print(Eval(Read(StandardInput), CurrentEnv), StandardOutput);
+            // (Read before fetching "CurrentEnv", since a command may collect garbage.)
+            Form *form = Read(StandardInput);
+            status = Print(Eval(form, CurrentEnv), StandardOutput);
             fprintf(StandardOutput, "\n");
         } else if (retval == kCaughtError) {
             if (IsInteractive)
               Message(";;; Psil Top-Level Restarted!\n");
             RestoreStack(stackPtr);
+            RestoreRoots(rootPtr);
         } else if (retval == kExitInterpreter) {
             if (IsInteractive)
               Message(";;; Exiting Psil.\n");
@@ -85,6 +93,7 @@ int ParseFile(char *filename)
             DeInitializeEnvironment(CurrentEnv);
             CurrentEnv = TopLevelEnv = NULL;
             DeInitializeReader();
+            DeInitializeHeap();
         }
     }
 
@@ -94,17 +103,40 @@ int ParseFile(char *filename)
     return status;
 }
 
+void Usage(const char *program)
+{
+    fprintf(stderr, "Usage:  %s [-b] [-m <HeapLimitMB>] [<Filename>]\n", program);
+    fprintf(stderr, "  Evaluate Psil forms from standard input or the contents of <Filename>, if supplied.\n");
+    fprintf(stderr, "  -b                Compile closures to bytecode for the virtual machine.\n");
+    fprintf(stderr, "  -m <HeapLimitMB>  Limit the live heap to <HeapLimitMB> megabytes (0 ==> unlimited; default: %ld.)\n",
+            kDefaultHeapLimit / (1024 * 1024));
+}
+
 int main(int argc, char *argv[])
 {
     char *filename;
+    int option;
+
+    while ((option = getopt(argc, argv, "bm:")) != -1) {
+        switch (option) {
+          case 'b':
+              UseVM = true;
+              break;
+          case 'm':
+              HeapLimit = atol(optarg) * 1024 * 1024;
+              break;
+          default:
+              Usage(argv[0]);
+              return kPsilError;
+        }
+    }
 
-    if (argc == 1) {
+    if (optind == argc) {
         filename = (char *) "-";
-    } else if (argc == 2) {
-        filename = argv[1];
+    } else if (optind == argc - 1) {
+        filename = argv[optind];
     } else {
-        fprintf(stderr, "Usage:  %s [<Filename>]\n", argv[0]);
-        fprintf(stderr, "  Evaluate Psil forms from standard input or the contents of <Filename>, if supplied.\n");
+        Usage(argv[0]);
         return kPsilError;
     }
 
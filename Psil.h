@@ -32,6 +32,9 @@ const int kNoError         =  0;
 const int kCaughtError     = -1;
 const int kExitInterpreter = -2;
 
+// Default maximum number of bytes live after a garbage collection.
+const long kDefaultHeapLimit = 1024L * 1024 * 1024;
+
 
 // Define global variables.
 
@@ -40,6 +43,7 @@ extern Form *SymbolNIL;
 extern Form *SymbolT;
 extern Form *SymbolQUOTE;
 extern Form *SymbolLAMBDA;
+extern Form *SymbolResolvedLAMBDA;
 extern Form *SymbolIF;
 extern Form *SymbolSETQ;
 extern Form *SymbolDEFINE;
@@ -49,9 +53,16 @@ extern bool TraceEvaluator;
 extern bool TracePrimitives;
 extern bool TraceStack;
 
+extern bool UseVM;
+
+extern long KaratsubaThreshold;
+
 extern Environment *TopLevelEnv;
 extern Environment *CurrentEnv;
 
+extern unsigned long EnvironmentEpoch;
+extern unsigned long GlobalVersion;
+
 extern FILE    *StandardInput;
 extern FILE    *StandardOutput;
 extern FILE    *StandardError;
@@ -62,6 +73,10 @@ extern bool     InterpreterRunning;
 extern bool ReadEOF;
 extern int  ReadLevel;
 
+extern long HeapLimit;
+extern bool GCRequested;
+extern unsigned long GCEpoch;
+
 
 // Define function prototypes.
 
@@ -76,6 +91,27 @@ void  ErrorOut(const char *format, ...);
 Form *ErrorForm(const char *format, ...);
 
 
+// Heap functions:
+
+
+int          InitializeHeap(long heapLimit);
+void         DeInitializeHeap(void);
+Form        *AllocateForm(PsilType type);
+Form        *AllocateLongString(void);
+Environment *AllocateEnvironment(void);
+int          SaveRoots(void);
+void         RestoreRoots(int rp);
+void         ProtectForm(Form **form);
+void         ProtectEnvironment(Environment **env);
+void         WriteBarrier(Form *form, Form *value);
+void         EnvironmentWriteBarrier(Environment *env, Form *value);
+long         CollectGarbage(void);
+void         GCSafePoint(void);
+void         AddExternalBytes(long bytes);
+bool         IsYoungForm(Form *form);
+void         GetGCStatistics(GCStatistics *stats);
+
+
 // Stack machine functions:
 
 
@@ -85,13 +121,15 @@ void  RestoreStack(int sp);
 void  ResetStack(void);
 Form *Push(Form *form);
 Form *Pop(void);
+Form *Peek(int depth);
+void  VisitStack(FormVisitor *visitor);
 
 
 // Command functions:
 
 
 bool  DoCommand(char *cmd_line);
-char *ReadCommand(FILE *instream, char *cmd_line);
+char *ReadCommand(PsilInput *input, char *cmd_line);
 
 
 // Environment functions:
@@ -99,11 +137,17 @@ char *ReadCommand(FILE *instream, char *cmd_line);
 
 Environment *InitializeEnvironment(void);
 void         DeInitializeEnvironment(Environment *env);
-Form        *Lookup(const char *name, Environment *env);
+Form        *Lookup(Form *symbol, Environment *env);
+Form        *LookupLocal(Form *local, Environment *env);
+Form        *SetLocal(Form *local, Form *value, Environment *env);
+Form        *LookupCallSite(Form *site);
 Environment *LookupBinding(const char *name, Environment *env);
 Environment *Bind(const char *name, Form *value, Environment *env);
-Environment *SetBinding(const char *name, Form *value, Environment *env);
+Environment *SetBinding(Form *variable, Form *value, Environment *env);
 Environment *Unbind(Environment *env);
+void         ReleaseEnvironment(Environment *env, Environment *parent, unsigned long epoch);
+void         FlushEnvironmentPool(void);
+void         GetEnvironmentStatistics(EnvironmentStatistics *stats);
 void         PrintEnvironment(Environment *env, FILE *outstream, bool verbose);
 
 
@@ -113,16 +157,156 @@ void         PrintEnvironment(Environment *env, FILE *outstream, bool verbose);
 int   InitializeReader(void);
 void  DeInitializeReader(void);
 Form *Intern(const char *token);
+void  VisitSymbols(FormVisitor *visitor);
+char  ReadToken(PsilInput *input, char **token, size_t *size);
+Form *ReadInput(PsilInput *input);
 Form *Read(FILE *instream);
+Form *ReadFromString(Form *string);
+
+
+// Input functions:
+
+
+PsilInput *OpenInputFile(FILE *file);
+PsilInput *OpenInputString(const char *chars, long length);
+void       CloseInput(PsilInput *input);
+int        FillInput(PsilInput *input);
+void       SkipInputSpace(PsilInput *input);
+size_t     InputTokenRun(PsilInput *input, const char **run);
+const char *ScanKernelsName(void);
+
+// Returns the next character of the input, or EOF.
+inline int InputChar(PsilInput *input)
+{
+    return (input->position < input->length) ? (unsigned char) input->chars[input->position++] : FillInput(input);
+}
+
+// Back up over the character just read (unless it was EOF.)
+inline void UnreadChar(PsilInput *input, int c)
+{
+    if ((c != EOF) && (input->position > 0))
+      input->position--;
+}
+
+
+// Output functions:
+
+
+PsilOutput *OpenOutput(FILE *file);
+void        CloseOutput(PsilOutput *output);
+void        FlushOutput(PsilOutput *output);
+char       *ReserveOutput(PsilOutput *output, size_t length);
+void        OutputChars(PsilOutput *output, const char *chars, size_t length);
+void        OutputString(PsilOutput *output, const char *string);
+void        OutputInteger(PsilOutput *output, PsilInteger integer);
+void        OutputFormat(PsilOutput *output, const char *format, ...);
+
+inline void OutputChar(PsilOutput *output, char c)
+{
+    if (output->length == output->size)
+      FlushOutput(output);
+    output->chars[output->length++] = c;
+}
 
 
 // Evaluator functions:
 
 
+bool  IsValidArglist(Form *arglist);
+Form *ResolveBody(Form *arglist, Form *body, Environment *env);
 Form *Eval(Form *form, Environment *env);
 Form *Apply(Form *func, Form *args, Environment *env);
 
 
+// Compiler and virtual machine functions:
+
+
+Form *CompileBody(Form *arglist, Form *body);
+Form *Execute(Form *code, Environment *env);
+
+
+// Bignum functions:
+
+
+Form  *BignumAdd(Form *x, Form *y);
+Form  *BignumSubtract(Form *x, Form *y);
+Form  *BignumMultiply(Form *x, Form *y);
+Form  *BignumDivide(Form *x, Form *y, Form **remainder);
+int    BignumCompare(Form *x, Form *y);
+double BignumToDouble(Form *x);
+Form  *DoubleToBignum(double number);
+Form  *BignumExpt(Form *x, PsilInteger power);
+Form  *ReadBignum(const char *token);
+char  *BignumToString(Form *x);
+
+
+// Array functions:
+
+
+Form       *MakeArray(Form *type, Form *length);
+Form       *ArrayRef(Form *array, Form *index);
+Form       *ArraySet(Form *array, Form *index, Form *value);
+Form       *ArrayLength(Form *array);
+Form       *ArrayAdd(Form *x, Form *y);
+Form       *ArrayMultiply(Form *x, Form *y);
+Form       *ArrayDot(Form *x, Form *y);
+Form       *ArraySum(Form *x);
+Form       *ArrayMin(Form *x);
+Form       *ArrayMax(Form *x);
+Form       *ArraySin(Form *x);
+Form       *ArrayExp(Form *x);
+Form       *ArrayLn(Form *x);
+const char *ArrayKernelsName(void);
+
+
+// Matrix functions:
+
+
+Form *MakeMatrix(Form *rows, Form *columns);
+Form *MatrixRef(Form *matrix, Form *row, Form *column);
+Form *MatrixSet(Form *matrix, Form *row, Form *column, Form *value);
+Form *MatrixRows(Form *matrix);
+Form *MatrixColumns(Form *matrix);
+Form *MatrixMultiply(Form *x, Form *y);
+Form *MatrixTranspose(Form *x);
+Form *MatrixAdd(Form *x, Form *y);
+Form *MatrixSubtract(Form *x, Form *y);
+Form *MatrixElementMultiply(Form *x, Form *y);
+Form *MatrixScale(Form *x, Form *scale);
+
+
+// Vector functions:
+
+
+Form *MakeVector(Form *length, Form *fill);
+Form *PopVector(long nargs);
+Form *VectorRef(Form *vector, Form *index);
+Form *VectorSet(Form *vector, Form *index, Form *value);
+Form *VectorLength(Form *vector);
+Form *ListToVector(Form *list);
+Form *VectorToList(Form *vector);
+
+
+// String functions:
+
+
+Form *StringEqual(Form *x, Form *y);
+Form *Substring(Form *string, Form *start, Form *end);
+Form *StringAppend(long nargs);
+Form *StringSearch(Form *pattern, Form *string, Form *start);
+
+
+// Hash table functions:
+
+
+Form *MakeHashTable(Form *test);
+Form *GetHash(Form *key, Form *table, Form *missing);
+Form *PutHash(Form *key, Form *value, Form *table);
+Form *RemHash(Form *key, Form *table);
+Form *MapHash(Form *func, Form *table);
+Form *HashTableCount(Form *table);
+
+
 // Printer functions:
 
 
@@ -135,14 +319,23 @@ int Print(Form *form, FILE *outstream);
 bool IsNull(Form *form);
 bool IsSymbol(Form *form);
 bool IsInteger(Form *form);
+bool IsBignum(Form *form);
 bool IsFlonum(Form *form);
 bool IsNumber(Form *form);
 bool IsString(Form *form);
 bool IsAtom(Form *form);
 bool IsCons(Form *form);
+bool IsArray(Form *form);
+bool IsMatrix(Form *form);
+bool IsVector(Form *form);
+bool IsHashTable(Form *form);
 bool IsFunc(Form *form);
 bool IsClosure(Form *form);
+bool IsLocal(Form *form);
+bool IsCode(Form *form);
+bool IsCallSite(Form *form);
 bool IsLambda(Form *form);
+bool IsResolvedLambda(Form *form);
 bool IsLambdaForm(Form *form);
 bool IsQuote(Form *form);
 bool IsIf(Form *form);
@@ -153,13 +346,26 @@ const char *TypeOf(Form *form);
 int Length(Form *list);
 
 const char  *SymbolName(Form *form);
-int          IntegerValue(Form *form);
+Form        *SymbolValue(Form *form);
+unsigned long SymbolHash(Form *form);
+PsilInteger  IntegerValue(Form *form);
 double       FlonumValue(Form *form);
+double       NumberValue(Form *form);
 const char  *StringValue(Form *form);
+long         StringLength(Form *form);
 PsilFunc    *FuncValue(Form *form);
 Form        *LambdaArglist(Form *form);
 Form        *LambdaBody(Form *form);
 Environment *LambdaEnvironment(Form *form);
+Form        *LambdaCode(Form *form);
+PsilArray   *ArrayValue(Form *form);
+PsilMatrix  *MatrixValue(Form *form);
+PsilVector  *VectorValue(Form *form);
+PsilHashTable *HashTableValue(Form *form);
+PsilCode    *CodeValue(Form *form);
+PsilCallSite *CallSiteValue(Form *form);
+Form        *LocalSymbol(Form *form);
+long         LocalDepth(Form *form);
 
 bool Eq(Form *x, Form *y);
 bool EqStr(Form *form, const char *string);
@@ -172,14 +378,21 @@ Form *Cdar(Form *form);
 Form *Cddr(Form *form);
 Form *Caddr(Form *form);
 Form *Cadddr(Form *form);
-Form *MakeSymbol(const char *pname);
-Form *MakeInteger(int integer);
+Form *MakeSymbol(const char *pname, unsigned long hash);
+Form *MakeInteger(PsilInteger integer);
 Form *MakeFlonum(double flonum);
 Form *MakeNumber(double number);
-Form *MakeString(const char *string);
+Form *MakeString(const char *chars, long length);
 Form *MakeFunc(PsilFunc *func);
 Form *MakeClosure(Form *arglist, Form *body, Environment *env);
+Form *MakeCallSite(Form *symbol);
+Form *MakeCode(Form *arglist, Form *body, long *ops, long numOps, Form **constants, long numConstants);
+Form *MakeLocal(Form *symbol, long depth);
 Form *Cons(Form *car, Form *cdr);
+Form *SetLambdaCode(Form *form, Form *code);
+Form *SetSymbolValue(Form *form, Form *value);
+Form *SetCar(Form *form, Form *car);
+Form *SetCdr(Form *form, Form *cdr);
 Form *NumberEqual(Form *x, Form *y);
 Form *Less(Form *x, Form *y);
 Form *LessEqual(Form *x, Form *y);
@@ -191,50 +404,98 @@ Form *Minus(Form *x, Form *y);
 Form *Times(Form *x, Form *y);
 Form *Divide(Form *x, Form *y);
 Form *Remainder(Form *x, Form *y);
+Form *Expt(Form *x, Form *y);
 Form *Equal(Form *x, Form *y);
 Form *Set(Form *x, Form *y);
 Form *Trace(Form *x, Form *y);
 Form *Exit(void);
 
-Form *FuncCar(void);
-Form *FuncCdr(void);
-Form *FuncCons(void);
-Form *FuncAtom(void);
-Form *FuncEq(void);
-Form *FuncNull(void);
-Form *FuncLength(void);
-Form *FuncTypeOf(void);
-Form *FuncSymbolp(void);
-Form *FuncNumberp(void);
-Form *FuncZerop(void);
-Form *FuncNumberEqual(void);
-Form *FuncLess(void);
-Form *FuncLessEqual(void);
-Form *FuncGreater(void);
-Form *FuncGreaterEqual(void);
-Form *FuncPlus(void);
-Form *FuncMinus(void);
-Form *FuncTimes(void);
-Form *FuncDivide(void);
-Form *FuncRemainder(void);
-Form *FuncAdd1(void);
-Form *FuncSub1(void);
-Form *FuncLn(void);
-Form *FuncExp(void);
-Form *FuncLog(void);
-Form *FuncExpt(void);
-Form *FuncSin(void);
-Form *FuncCos(void);
-Form *FuncTan(void);
-Form *FuncEqual(void);
-Form *FuncSet(void);
-Form *FuncTrace(void);
+Form *CallPrimitive(PsilFunc *pfunc, long nargs);
+Form *FuncCar(Form *x);
+Form *FuncCdr(Form *x);
+Form *FuncCons(Form *x, Form *y);
+Form *FuncRplaca(Form *x, Form *y);
+Form *FuncRplacd(Form *x, Form *y);
+Form *FuncAtom(Form *x);
+Form *FuncEq(Form *x, Form *y);
+Form *FuncNull(Form *x);
+Form *FuncLength(Form *x);
+Form *FuncTypeOf(Form *x);
+Form *FuncSymbolp(Form *x);
+Form *FuncNumberp(Form *x);
+Form *FuncZerop(Form *x);
+Form *FuncNumberEqual(Form *x, Form *y);
+Form *FuncLess(Form *x, Form *y);
+Form *FuncLessEqual(Form *x, Form *y);
+Form *FuncGreater(Form *x, Form *y);
+Form *FuncGreaterEqual(Form *x, Form *y);
+Form *FuncPlus(Form *x, Form *y);
+Form *FuncMinus(Form *x, Form *y);
+Form *FuncTimes(Form *x, Form *y);
+Form *FuncDivide(Form *x, Form *y);
+Form *FuncRemainder(Form *x, Form *y);
+Form *FuncAdd1(Form *x);
+Form *FuncSub1(Form *x);
+Form *FuncLn(Form *x);
+Form *FuncExp(Form *x);
+Form *FuncLog(Form *x, Form *y);
+Form *FuncExpt(Form *x, Form *y);
+Form *FuncSin(Form *x);
+Form *FuncCos(Form *x);
+Form *FuncTan(Form *x);
+Form *FuncEqual(Form *x, Form *y);
+Form *FuncSet(Form *x, Form *y);
+Form *FuncTrace(Form *x);
 Form *FuncExit(void);
 Form *FuncRead(void);
-Form *FuncEval(void);
-Form *FuncApply(void);
-Form *FuncPrin1(void);
-Form *FuncPrint(void);
+Form *FuncReadFromString(Form *x);
+Form *FuncEval(Form *x);
+Form *FuncApply(Form *func, Form *args);
+Form *FuncPrin1(Form *x);
+Form *FuncPrint(Form *x);
+Form *FuncGC(void);
+Form *FuncMakeArray(Form *x, Form *y);
+Form *FuncAref(Form *x, Form *y);
+Form *FuncAset(void);
+Form *FuncArrayLength(Form *x);
+Form *FuncArrayAdd(Form *x, Form *y);
+Form *FuncArrayMultiply(Form *x, Form *y);
+Form *FuncArrayDot(Form *x, Form *y);
+Form *FuncArraySum(Form *x);
+Form *FuncArrayMin(Form *x);
+Form *FuncArrayMax(Form *x);
+Form *FuncArraySin(Form *x);
+Form *FuncArrayExp(Form *x);
+Form *FuncArrayLn(Form *x);
+Form *FuncMakeMatrix(Form *x, Form *y);
+Form *FuncMatrixRef(void);
+Form *FuncMatrixSet(void);
+Form *FuncMatrixRows(Form *x);
+Form *FuncMatrixColumns(Form *x);
+Form *FuncMatmul(Form *x, Form *y);
+Form *FuncTranspose(Form *x);
+Form *FuncMatrixAdd(Form *x, Form *y);
+Form *FuncMatrixSubtract(Form *x, Form *y);
+Form *FuncMatrixMultiply(Form *x, Form *y);
+Form *FuncMatrixScale(Form *x, Form *y);
+Form *FuncVector(long nargs);
+Form *FuncMakeVector(long nargs);
+Form *FuncVectorRef(Form *x, Form *y);
+Form *FuncVectorSet(void);
+Form *FuncVectorLength(Form *x);
+Form *FuncListToVector(Form *x);
+Form *FuncVectorToList(Form *x);
+Form *FuncMakeHashTable(long nargs);
+Form *FuncGetHash(long nargs);
+Form *FuncPutHash(void);
+Form *FuncRemHash(Form *x, Form *y);
+Form *FuncMapHash(Form *x, Form *y);
+Form *FuncHashTableCount(Form *x);
+Form *FuncStringLength(Form *x);
+Form *FuncSubstring(long nargs);
+Form *FuncStringAppend(long nargs);
+Form *FuncStringEqual(Form *x, Form *y);
+Form *FuncStringSearch(long nargs);
 
 
 #endif // !defined(Psil_h)
@@ -17,6 +17,9 @@
 // Include declarations files.
 
 
+#include <stdint.h>
+
+
 // Define constants.
 
 
@@ -45,10 +48,19 @@ const char  kColon       = ':';
 
 const int   kMaxTokenLen = 256;
 
+// Integers are encoded directly in the form pointer as tagged immediate
+// "fixnums", distinguished by having their low bit set.  (Heap forms are
+// always at least word-aligned, so their low bit is always clear.)
+const uintptr_t kFixnumTag          = 0x1;
+const int       kFixnumShift        = 1;
+const intptr_t  kMostPositiveFixnum = INTPTR_MAX >> kFixnumShift;
+const intptr_t  kMostNegativeFixnum = INTPTR_MIN >> kFixnumShift;
+
 
 // Define types.
 
 
+typedef struct Form        Form;
 typedef struct Environment Environment;
 
 typedef enum PsilType {
@@ -56,74 +68,340 @@ typedef enum PsilType {
     kPsilBoolean,
     kPsilSymbol,
     kPsilInteger,
+    // (An integer too large for "PsilInteger".)
+    kPsilBignum,
     kPsilFlonum,
     kPsilString,
     kPsilCons,
     kPsilFunc,
-    kPsilLambda
+    kPsilLambda,
+    // (A homogeneous array of unboxed numbers.)
+    kPsilArray,
+    // (A dense matrix of unboxed flonums.)
+    kPsilMatrix,
+    // (A one-dimensional array of arbitrary forms.)
+    kPsilVector,
+    // (A table of keys and values, compared by "EQ" or "EQUAL".)
+    kPsilHashTable,
+    // (A variable reference resolved to its lexical address within a closure body.)
+    kPsilLocal,
+    // (The bytecode compiled from a lambda body.)
+    kPsilCode,
+    // (A global function reference, with a cache of its value.)
+    kPsilCallSite,
+    // (Not a first-class type, but environment bindings have heap pages, too.)
+    kPsilEnvironment,
+    kNumPsilTypes
 } PsilType;
 
 typedef struct PsilSymbol {
     const char  *pname;
-    struct Form *value;
+    Form        *value;
+    // (The hash of the pname, as computed by the reader for interning.)
+    unsigned long hash;
 #if 0
     // (This would be used if Psil were not a 1-LISP.)
-    struct Form *functionValue;
+    Form        *functionValue;
     // (Not yet used.)
-    struct Form *plist;
+    Form        *plist;
     // (Not yet used.)
-    struct Form *package;
+    Form        *package;
 #endif
 } PsilSymbol;
 
-typedef const char *PsilString;
+// Strings shorter than this are kept inline, in the string's own heap cell.
+const long kShortStringSize = 24;
+
+// A string has an explicit length, so it may contain NULs, but its
+//  characters are always followed by a NUL, too.
+// (The characters of long strings are "malloc()"'d, and freed with the string.)
+typedef struct PsilString {
+    long         length;
+    union {
+        char    *chars;
+        char     shortChars[kShortStringSize];
+    };
+} PsilString;
+
+// (Integers which fit are immediate fixnums; others are boxed in the heap.)
+typedef int64_t PsilInteger;
 
-typedef int PsilInteger;
+// The magnitude of a bignum is "length" base 2^32 digits, least significant
+//  first, with no leading zeros, and its sign is -1 or 1.  Bignums are only
+//  made for values which are not representable as "PsilInteger"s.
+// (The digits are "malloc()"'d, and freed with the bignum.)
+typedef struct PsilBignum {
+    uint32_t    *digits;
+    long         length;
+    int          sign;
+} PsilBignum;
 
 #ifdef FLONUM_IS_DOUBLE
-// (Note:  This increases the size of the Form structure by 50% on 32-bit architectures.)
+// (Note:  This doubles the size of flonum cells on 32-bit architectures.)
 typedef double PsilFlonum;
 #else
 typedef float PsilFlonum;
 #endif // FLONUM_IS_DOUBLE
 
+typedef enum PsilElementType {
+    kPsilF64,
+    kPsilI64
+} PsilElementType;
+
+// The elements of an array are stored contiguously and unboxed, as
+//  "double"s or "PsilInteger"s, according to its element type.
+// (The elements are "malloc()"'d, and freed with the array.)
+typedef struct PsilArray {
+    void            *data;
+    long             length;
+    PsilElementType  elementType;
+} PsilArray;
+
+// The elements of a matrix are stored contiguously and unboxed, as "double"s, in row-major order.
+// (The elements are "malloc()"'d, and freed with the matrix.)
+typedef struct PsilMatrix {
+    double          *data;
+    long             rows;
+    long             columns;
+} PsilMatrix;
+
+// The elements of a (simple) vector are any forms, stored contiguously.
+// (The elements are "malloc()"'d, and freed with the vector.)
+typedef struct PsilVector {
+    Form           **elements;
+    long             length;
+} PsilVector;
+
+typedef enum PsilHashTest {
+    kPsilHashEq,
+    kPsilHashEqual
+} PsilHashTest;
+
+// The hashes of empty and deleted hash table entries.
+// (Keys are never given these hashes.)
+const unsigned long kEmptyHash   = 0;
+const unsigned long kDeletedHash = 1;
+
+typedef struct PsilHashEntry {
+    unsigned long    hash;
+    Form            *key;
+    Form            *value;
+} PsilHashEntry;
+
+// A hash table is open-addressed.  While it is growing, some of its
+//  entries are still in the old entries, which are moved a few at a time.
+// (The entries are "malloc()"'d, and freed with the table.)
+typedef struct PsilHashTable {
+    PsilHashEntry   *entries;
+    long             capacity;
+    // (The number of entries which are not empty, i.e., including those deleted.)
+    long             used;
+    // (The number of keys, in both the entries and the old entries.)
+    long             count;
+    PsilHashEntry   *oldEntries;
+    long             oldCapacity;
+    // (The old entries before this index have been moved.)
+    long             migrated;
+    PsilHashTest     test;
+    // (Whether any keys are hashed by the address of a form which was young at "epoch".)
+    bool             youngKeys;
+    unsigned long    epoch;
+} PsilHashTable;
+
 typedef struct PsilCons {
-    struct Form *car;
-    struct Form *cdr;
+    Form *car;
+    Form *cdr;
 } PsilCons;
 
+// Primitives of one or two arguments take them directly as parameters,
+//  while others pop them from the stack.
+// (Primitives taking any number of arguments are passed how many to pop.)
 typedef Form *(PrimitiveFunc)(void);
+typedef Form *(PrimitiveFunc1)(Form *x);
+typedef Form *(PrimitiveFunc2)(Form *x, Form *y);
+typedef Form *(PrimitiveFuncN)(long nargs);
+
+// The "nargs" of a primitive taking any number of arguments.
+const int kVariadicArgs = -1;
 
 typedef struct PsilFunc {
-    const char    *name;
-    PrimitiveFunc *func;
-    int            nargs;
+    const char     *name;
+    int             nargs;
+    // (The entry point for the number of arguments; the others are NULL.)
+    PrimitiveFunc  *func;
+    PrimitiveFunc1 *func1;
+    PrimitiveFunc2 *func2;
+    PrimitiveFuncN *funcN;
 } PsilFunc;
 
 typedef struct PsilLambda {
-    struct Form *arglist;
-    struct Form *body;
+    Form        *arglist;
+    Form        *body;
     Environment *env;
+    // (The compiled body, or NULL if the body is only interpreted.)
+    Form        *code;
 } PsilLambda;
 
-// Note:  This structure is large enough to contain an
-//         entire CONS cell and its type.  It could be
-//         made smaller if we instead stored a pointer
-//         to CONS cells instead.  And the type could
-//         potentially be determined by where the form
-//         is allocated in memory.
-typedef struct Form {
+// The binding of a local variable is "depth" bindings up the environment.
+typedef struct PsilLocal {
+    Form        *symbol;
+    long         depth;
+} PsilLocal;
+
+// A call to a global function caches its value, which is valid while
+//  "GlobalVersion" (incremented whenever a global is set) equals "version".
+typedef struct PsilCallSite {
+    Form         *symbol;
+    Form         *value;
+    unsigned long version;
+} PsilCallSite;
+
+// The bytecode virtual machine's instructions.
+// (Each opcode is followed by the operand given in its comment, if any.)
+typedef enum PsilOpcode {
+    kOpConstant,        // Push constant <index>.
+    kOpLocal,           // Push the value of local constant <index>.
+    kOpGlobal,          // Push the global value of symbol constant <index>.
+    kOpSetLocal,        // Set local constant <index> to the top of the stack.
+    kOpSetGlobal,       // Set symbol constant <index> to the top of the stack.
+    kOpPop,             // Discard the top of the stack.
+    kOpJump,            // Jump to <pc>.
+    kOpJumpIfNil,       // Pop the stack, and jump to <pc> if it was NIL.
+    kOpCall,            // Call the function below <nargs> arguments on the stack.
+    kOpTailCall,        // Call, replacing the current frame if the function is compiled.
+    kOpClosure,         // Push a closure of code constant <index>.
+    kOpEval,            // Push the value of interpreting form constant <index>.
+    kOpReturn,          // Return the top of the stack.
+    kNumPsilOpcodes
+} PsilOpcode;
+
+// The instructions and constants compiled from a lambda body.
+// (The instructions and constants are "malloc()"'d, and freed with the code.)
+typedef struct PsilCode {
+    Form        *arglist;
+    Form        *body;
+    long        *ops;
+    long         numOps;
+    Form       **constants;
+    long         numConstants;
+    // (Whether the opcodes have been replaced by the addresses of their handlers.)
+    bool         threaded;
+} PsilCode;
+
+// Note:  Forms do not store their type.  Each type of form is
+//         allocated from its own heap pages, and the type is
+//         determined by the header of the page the form is in.
+//         A form's heap cell is only as large as the member for
+//         its type, e.g., a CONS cell is exactly two words.
+// (Integers are never allocated, since they are tagged fixnums.)
+struct Form {
     union {
-        PsilSymbol  *symbol;
+        PsilSymbol   symbol;
         PsilInteger  integer;
+        PsilBignum   bignum;
         PsilFlonum   flonum;
         PsilString   string;
         PsilCons     list;
         PsilFunc    *func;
-        PsilLambda  *lambda;
+        PsilLambda   lambda;
+        PsilArray    array;
+        PsilMatrix   matrix;
+        PsilVector   vector;
+        PsilHashTable hashTable;
+        PsilLocal    local;
+        PsilCode     code;
+        PsilCallSite callSite;
     } value;
+};
+
+// Heap pages are aligned to their size, and begin with this header.
+const size_t kPageSize = 65536;
+
+typedef struct PageHeader {
     PsilType type;
-} Form;
+} PageHeader;
+
+// An "a-list"-style environment binding.
+struct Environment {
+    const char  *name;
+    Form        *value;
+    Environment *parent;
+};
+
+// The reader's input:  The characters of a regular file are memory-mapped,
+//  those of other files (e.g., pipes and terminals) are read a block at a
+//  time into a buffer, and those of a string are copied.
+typedef struct PsilInput {
+    // (The file read, or NULL for a string.)
+    FILE        *file;
+    int          fd;
+    // (The characters available, which are the mapping, the buffer or the string.)
+    const char  *chars;
+    size_t       length;
+    size_t       position;
+    char        *buffer;
+    size_t       bufferSize;
+    void        *mapping;
+    size_t       mappingLength;
+} PsilInput;
+
+// The printer's output:  Characters are collected in a buffer, and only
+//  written to the file when a form has been printed, or the buffer fills.
+typedef struct PsilOutput {
+    FILE        *file;
+    char        *chars;
+    size_t       length;
+    size_t       size;
+} PsilOutput;
+
+// Used by the garbage collector to visit root pointers held by other modules.
+typedef void (FormVisitor)(Form **form);
+
+typedef struct GCStatistics {
+    long   minorCollections;
+    long   bytesPromoted;
+    double minorMilliseconds;
+    long   collections;
+    long   lastObjectsReclaimed;
+    long   lastBytesReclaimed;
+    double lastMilliseconds;
+    long   totalBytesReclaimed;
+    double totalMilliseconds;
+    long   bytesInUse;
+    long   heapLimit;
+    long   numPages;
+    long   pageSize;
+} GCStatistics;
+
+typedef struct EnvironmentStatistics {
+    long allocated;
+    long reused;
+    long released;
+    long retained;
+    long flushed;
+    long pooled;
+} EnvironmentStatistics;
+
+inline bool IsFixnum(const Form *form)
+{
+    return ((uintptr_t) form & kFixnumTag) != 0;
+}
+
+inline Form *FixnumForm(intptr_t value)
+{
+    return (Form *) (((uintptr_t) value << kFixnumShift) | kFixnumTag);
+}
+
+inline intptr_t FixnumValue(const Form *form)
+{
+    return (intptr_t) form >> kFixnumShift;
+}
+
+// The type of a heap-allocated object.
+inline PsilType PageType(const void *cell)
+{
+    return ((const PageHeader *) ((uintptr_t) cell & ~(uintptr_t) (kPageSize - 1)))->type;
+}
 
 typedef bool (CmdFunc)(char *cmd_line);
 
@@ -6,11 +6,14 @@
     Description:
        Psil reader.
 
+       The reader takes its characters from an input buffer (see
+       "Input.cpp"), whether a file's or a string's, and only looks ahead
+       by backing up over the last character read.
+
        XXX -- Features Currently Missing:
        ----------------------------------
         - Support for backslash, backquote, etc.
         - Support for reading dotted lists.
-        - Support for reading strings.
         - Support for readtables.
 
     Copyright (c) 1999-2019 Joseph J. Mankoski ***PSI***
@@ -23,10 +26,7 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
-#include <search.h>
-#ifdef __sparc
-#include <alloca.h>
-#endif
+#include <charconv>
 #include "Psil.h"
 
 
@@ -34,7 +34,21 @@
 
 
 // Initial size of the symbol hash table.
-static const int kInitialSymbolHashTableSize = 101;
+// (This must be a power of two.)
+static const long kInitialSymbolTableSize = 1024;
+
+
+// Define types.
+
+
+// A list, vector or quoted form being read.
+typedef struct ReadFrame {
+    // (The kind of form:  "kLeftParen", "kSharp" or "kQuote".)
+    char         kind;
+    // (The elements read so far.)
+    Form        *head;
+    Form        *tail;
+} ReadFrame;
 
 
 // Define global variables.
@@ -55,27 +69,107 @@ Form *SymbolNIL;
 Form *SymbolT;
 Form *SymbolQUOTE;
 Form *SymbolLAMBDA;
+Form *SymbolResolvedLAMBDA;
 Form *SymbolIF;
 Form *SymbolSETQ;
 Form *SymbolDEFINE;
 
-// Has an EOF character been read?
+// The symbol hash table, which is an open-addressed table of all interned
+//  symbols, probed linearly, and doubled in size whenever it is half full.
+// (These symbols are roots for the garbage collector.)
+static Form **SymbolTable = NULL;
+static long SymbolTableSize = 0;
+static long NumSymbols = 0;
+
+// Has an EOF character been read (from a file)?
 bool ReadEOF = false;
 
-// Recursive read level.
+// The input buffering the file most recently read by "Read()".
+static PsilInput *FileInput = NULL;
+
+// The input of the string most recently read by "ReadFromString()".
+static PsilInput *StringInput = NULL;
+
+// Recursive read level, i.e., the number of lists being read.
 // Level 0 is "top level" where commands are available.
 int ReadLevel = 0;
 
+// The stack of lists (and quoted forms) being read.
+static ReadFrame *ReadFrames = NULL;
+static long ReadFramesSize = 0;
+
+// The buffer of the token being read, which grows to hold the longest token read.
+static char *TokenBuffer = NULL;
+static size_t TokenBufferSize = 0;
+
 
 // Define functions.
 
 
+// Psil is case-insensitive, so symbols are named in uppercase.
+// (The Psil language is defined over ASCII, so this need not use the locale.)
+static inline char FoldCase(char chr)
+{
+    return ((chr >= 'a') && (chr <= 'z')) ? (chr - 'a' + 'A') : chr;
+}
+
+// Returns the (FNV-1a) hash of the name, folding its case, and its length.
+static inline unsigned long HashName(const char *name, size_t *length)
+{
+    const char *chr = name;
+    uint32_t hash = 2166136261u;
+
+    while (*chr) {
+        hash ^= (unsigned char) FoldCase(*chr++);
+        hash *= 16777619u;
+    }
+
+    *length = chr - name;
+
+    return hash;
+}
+
+// Does the name match the (uppercase) pname, ignoring case?
+static inline bool NameEqual(const char *name, const char *pname)
+{
+    while (*pname && (FoldCase(*name) == *pname))
+      name++, pname++;
+
+    return !*name && !*pname;
+}
+
+static void GrowSymbolTable(void)
+{
+    long size = SymbolTableSize ? 2 * SymbolTableSize : kInitialSymbolTableSize;
+    Form **table = (Form **) calloc(size, sizeof(Form *));
+
+    if (!table)
+      ErrorOut("GrowSymbolTable():  Failed to grow the symbol table to size %ld!\n", size);
+
+    for (long index = 0; index < SymbolTableSize; index++) {
+        Form *symbol = SymbolTable[index];
+        if (symbol) {
+            long probe = SymbolHash(symbol) & (size - 1);
+            while (table[probe])
+              probe = (probe + 1) & (size - 1);
+            table[probe] = symbol;
+        }
+    }
+
+    free((void *) SymbolTable);
+    SymbolTable = table;
+    SymbolTableSize = size;
+}
+
 void MakeStandardSymbols(void)
 {
     SymbolNIL = Intern(kNIL);
     SymbolT = Intern(kT);
     SymbolQUOTE = Intern(kQUOTE);
     SymbolLAMBDA = Intern(kLAMBDA);
+    // (Marks lambda forms whose bodies have been resolved.  It is not interned,
+    //  so it cannot be read.)
+    SymbolResolvedLAMBDA = MakeSymbol(kLAMBDA, 0);
     SymbolIF = Intern(kIF);
     SymbolSETQ = Intern(kSETQ);
     SymbolDEFINE = Intern(kDEFINE);
@@ -83,208 +177,341 @@ void MakeStandardSymbols(void)
 
 int InitializeReader(void)
 {
-    if (hcreate(kInitialSymbolHashTableSize)) {
-        MakeStandardSymbols();
-        ReaderInitialized = true;
-        return kPsilOK;
-    } else
-      return Error("InitializeReader():  Failed to create token hash table!\n");
+    GrowSymbolTable();
+    MakeStandardSymbols();
+    ReaderInitialized = true;
+
+    return kPsilOK;
 }
 
 void DeInitializeReader(void)
 {
     if (ReaderInitialized) {
-        // XXX -- Should also release the "strdup()"'d tokens here!
-        hdestroy();
+        // Release the interned symbols' names.
+        // (The symbols themselves are released along with the heap.)
+        for (long index = 0; index < SymbolTableSize; index++)
+          if (SymbolTable[index])
+            free((void *) SymbolName(SymbolTable[index]));
+        free((void *) SymbolTable);
+        SymbolTable = NULL;
+        SymbolTableSize = NumSymbols = 0;
+        CloseInput(FileInput);
+        CloseInput(StringInput);
+        FileInput = StringInput = NULL;
+        free((void *) ReadFrames);
+        ReadFrames = NULL;
+        ReadFramesSize = 0;
+        free((void *) TokenBuffer);
+        TokenBuffer = NULL;
+        TokenBufferSize = 0;
         ReaderInitialized = false;
     }
 }
 
 Form *Intern(const char *token)
 {
-    // Normalize the token by making a temporary copy on the stack....
-    int tokenLen = strlen(token);
-    char *tokenUppercase = (char *) alloca(tokenLen + 1);
-    char *tokenUppercasePtr = tokenUppercase;
-
-    // And converting it to uppercase.
-    while ((*tokenUppercasePtr++ = toupper(*token++)))
-      ;
-
-    // Search for a symbol having the normalized token as its pname.
-    ENTRY tokenEntry, *tokenEntryPtr;
-    tokenEntry.key = tokenUppercase;
-    if ((tokenEntryPtr = hsearch(tokenEntry, FIND)) == NULL) {
-        // If not found, make a new symbol and add it to the symbol hash table.
-        tokenEntry.key = strdup(tokenUppercase);
-        tokenEntry.data = (char *) MakeSymbol((const char *) tokenEntry.key);
-        if ((tokenEntryPtr = hsearch(tokenEntry, ENTER)) == NULL)
-          ErrorOut("Intern():  Failed to add token \"%s\" to the symbol hash table!\n");
+    size_t length;
+    unsigned long hash = HashName(token, &length);
+    long probe = hash & (SymbolTableSize - 1);
+    Form *symbol;
+
+    // Search for a symbol having the token as its pname (ignoring case.)
+    while ((symbol = SymbolTable[probe])) {
+        if ((SymbolHash(symbol) == hash) && NameEqual(token, SymbolName(symbol)))
+          return symbol;
+        probe = (probe + 1) & (SymbolTableSize - 1);
     }
 
+    // If not found, make a new symbol named by the token in uppercase.
+    char *pname = (char *) malloc(length + 1);
+    if (!pname)
+      ErrorOut("Intern():  Failed to allocate the name of symbol \"%s\"!\n", token);
+    for (size_t index = 0; index <= length; index++)
+      pname[index] = FoldCase(token[index]);
+
+    // And add it to the symbol hash table.
+    symbol = SymbolTable[probe] = MakeSymbol(pname, hash);
+    if (2 * ++NumSymbols > SymbolTableSize)
+      GrowSymbolTable();
+
     // Return the unique symbol.
-    return (Form *) tokenEntryPtr->data;
+    return symbol;
 }
 
-bool ParseInteger(const char *token, int &integer)
+void VisitSymbols(FormVisitor *visitor)
+{
+    for (long index = 0; index < SymbolTableSize; index++)
+      if (SymbolTable[index])
+        visitor(&SymbolTable[index]);
+
+    visitor(&SymbolResolvedLAMBDA);
+}
+// Returns the start of the digits of a number, after any sign, or NULL if the token cannot be a number.
+// (So "std::from_chars()", which accepts neither a plus sign nor a minus sign after it, nor
+//  initial digits which are not decimal, sees only what it should.)
+static const char *NumberDigits(const char *token, const char *end)
 {
-    bool success = false, sawDigit = false;
     const char *ptr = token;
 
     // Look for optional leading sign.
-    if ((*ptr == '+') || (*ptr == '-'))
+    if ((ptr < end) && ((*ptr == kPlus) || (*ptr == kMinus)))
       ptr++;
 
-    // Look for a sequence of decimal digits.
-    while (*ptr && isdigit(*ptr)) {
-        sawDigit = true;
-        ptr++;
-    }
+    // Look for a decimal digit, or a decimal point followed by one.
+    if ((ptr < end) && (isdigit(*ptr) || ((*ptr == kPoint) && (ptr + 1 < end) && isdigit(ptr[1]))))
+      return ptr;
 
-    // Look for an optional trailing decimal point.
-    if (sawDigit && (*ptr == '.'))
-      ptr++;
-
-    // Check for successfully reaching the end of the token.
-    if (sawDigit && !*ptr) {
-        success = true;
-        integer = atoi(token);
-    }
-
-    return success;
+    return NULL;
 }
 
-bool ParseFlonum(const char *token, double &flonum)
+// (An integer too large for 64 bits is parsed, but "overflow" is set.)
+// (A trailing decimal point is allowed.)
+bool ParseInteger(const char *token, const char *end, PsilInteger &integer, bool &overflow)
 {
-    bool success = false, sawDigit = false, sawPoint = false;
-    const char *ptr = token;
+    const char *digits = NumberDigits(token, end);
 
-    // Look for optional leading sign.
-    if ((*ptr == '+') || (*ptr == '-'))
-      ptr++;
+    if (!digits || !isdigit(*digits))
+      return false;
 
-    // Look for a sequence of decimal digits, with an optional decimal point.
-    while (*ptr && (isdigit(*ptr) || (*ptr == '.'))) {
-        // Look for one and only one optional decimal point.
-        if (*ptr == '.') {
-            if (sawPoint)
-              return false;
-            else
-              sawPoint = true;
-        } else {
-            sawDigit = true;
-        }
-        ptr++;
-    }
+    // (The digits are parsed unsigned, so that the most negative integer parses too.)
+    uint64_t magnitude = 0;
+    std::from_chars_result result = std::from_chars(digits, end, magnitude);
+    bool negative = (*token == kMinus);
 
-    // Look for optional exponent.
-    if (sawDigit && ((*ptr == 'e') || (*ptr == 'E'))) {
-        ptr++;
+    if ((result.ptr < end) && (*result.ptr == kPoint))
+      result.ptr++;
 
-        // Look for optional exponent sign.
-        if ((*ptr == '+') || (*ptr == '-'))
-          ptr++;
+    if (result.ptr != end)
+      return false;
 
-        // Require at least one digit in the exponent.
-        if (!isdigit(*ptr))
-          return false;
+    overflow = (result.ec == std::errc::result_out_of_range) || (magnitude > (uint64_t) INT64_MAX + negative);
+    integer = negative ? (PsilInteger) (0 - magnitude) : (PsilInteger) magnitude;
 
-        // XXX -- This allows any size of exponent > 1 digit!
-        while (*ptr && isdigit(*ptr))
-          ptr++;
-    }
+    return true;
+}
 
-    // Check for successfully reaching the end of the token.
-    if (sawDigit && !*ptr) {
-        success = true;
-        flonum = atof(token);
-    }
+// Parse a decimal number with an optional decimal point and exponent, rounding it directly to the
+//  nearest flonum (so that a flonum printed by the shortest digits which round to it reads back
+//  exactly.)
+bool ParseFlonum(const char *token, const char *end, double &flonum)
+{
+    const char *digits = NumberDigits(token, end);
+    PsilFlonum value;
 
-    return success;
+    if (!digits)
+      return false;
+
+    std::from_chars_result result = std::from_chars(digits, end, value, std::chars_format::general);
+
+    if (result.ptr != end)
+      return false;
+
+    if (result.ec == std::errc::result_out_of_range)
+      // (Overflow to infinity, or underflow to zero.)
+      value = (PsilFlonum) strtod(digits, NULL);
+
+    flonum = (*token == kMinus) ? -value : value;
+
+    return true;
 }
 
-// XXX -- Comments are not really NOPs, since they should
-//         actually terminate any current token.
-char ReadChar(FILE *instream)
+// (Suspending and resuming the process, e.g., on macOS, isn't really EOF, so "FillInput()" retries the read.)
+char ReadChar(PsilInput *input)
 {
-    char c;
+    int c;
 
  StartOver:
-    ReadEOF = ((c = fgetc(instream)) == EOF);
-
-    // Suspending and resuming the process (e.g., on macOS) isn't really EOF.
-    if (ferror(instream) && !feof(instream)) {
-        clearerr(instream);
-        goto StartOver;
-    }
+    c = InputChar(input);
 
     // If a comment character is found, read it until the next newline.
     if (c == kCommentChar) {
-        while (((c = fgetc(instream)) != '\n') && (c != EOF))
+        while (((c = InputChar(input)) != '\n') && (c != EOF))
           ;
         if (c != EOF)
           goto StartOver;
-        else
-          ReadEOF = true;
     }
 
+    // (Only the end of a file ends the interpreter.)
+    if (input->file)
+      ReadEOF = (c == EOF);
+
     return c;
 }
 
-char ReadToken(FILE *instream, char *token)
+// Make the (malloc()'d) token buffer hold at least "length" characters.
+static void GrowToken(char **token, size_t *size, size_t length)
 {
-    char c;
-    int index = 0;
+    if (length <= *size)
+      return;
 
-    token[index] = '\0';
+    size_t newSize = *size ? *size : kMaxTokenLen;
+    while (newSize < length)
+      newSize *= 2;
 
-    // Read any leading whitespace.
-    while (((c = ReadChar(instream)) != EOF)
-           && ((c == kSpace) || (c == kTab) || (c == kReturn) || (c == kNewline)))
-      ;
+    char *larger = (char *) realloc(*token, newSize);
+    if (!larger) {
+        ErrorForm("ReadToken():  Failed to grow the token buffer to %ld characters!\n", (long) newSize);
+        return;
+    }
 
-    if (c == EOF)
-      return EOF;
+    *token = larger;
+    *size = newSize;
+}
+
+// Read the next token into the (malloc()'d) buffer, growing it as needed, so tokens
+//  (e.g., huge integers) may be any length.
+char ReadToken(PsilInput *input, char **tokenBuffer, size_t *size)
+{
+    const char *run;
+    size_t count, index = 0;
+    char *token, c;
+
+    // (Room for a delimiter, or "#(", and the NUL.)
+    GrowToken(tokenBuffer, size, 3);
+
+    // Skip any leading whitespace (and comments.)
+    SkipInputSpace(input);
 
     // XXX -- Still need to handle backslash, backquote, etc.
 
-    // Accumulate the character.
-    token[index++] = c;
+    // Accumulate a token a run of characters at a time, up to the next whitespace,
+    //  delimiter or comment (which is left in the input.)
+    while ((count = InputTokenRun(input, &run)) > 0) {
+        GrowToken(tokenBuffer, size, index + count + 1);
+        memcpy(*tokenBuffer + index, run, count);
+        index += count;
+        // (A token only continues past the end of the characters buffered.)
+        if (input->position < input->length)
+          break;
+    }
+
+    token = *tokenBuffer;
 
-    // Return token if we have it all now.
-    if ((c == kLeftParen) || (c == kRightParen) || (c == kQuote)
-        || (c == kBackQuote) || (c == kAtSign) || (c == kColon)) {
-        token[index] = '\0';
+    // Otherwise, the next character is a delimiter, which is returned, as is EOF.
+    // (A double quote begins a string, which is read by "ReadString()".)
+    if (index == 0) {
+        c = ReadChar(input);
+        token[0] = (c == EOF) ? '\0' : c;
+        token[1] = '\0';
         return c;
     }
 
-    while (((c = ReadChar(instream)) != EOF) && (c != kSpace) && (c != kTab)
-           && (c != kReturn) && (c != kNewline) && (c != kLeftParen)
-           && (c != kRightParen) && (c != kQuote)
-           && (c != kBackQuote) && (c != kAtSign) && (c != kColon))
-      token[index++] = c;
+    token[index] = '\0';
 
-    // Push the last character back on the input stream.
-    ungetc(c, instream);
+    // (Note whether the token ended the file.)
+    if (input->file)
+      ReadEOF = (input->position >= input->length);
 
-    token[index] = '\0';
+    // A sharp sign followed by a left paren begins a vector.
+    if ((index == 1) && (token[0] == kSharp)) {
+        if ((c = InputChar(input)) == kLeftParen) {
+            token[index++] = c;
+            token[index] = '\0';
+            return kSharp;
+        }
+        UnreadChar(input, c);
+    }
 
     // XXX -- What should this case return?
     return '\0';
 }
 
 
+// Returns the value of the hexadecimal digit, or -1.
+static int HexDigitValue(int c)
+{
+    if ((c >= '0') && (c <= '9'))
+      return c - '0';
+    else if ((c >= 'a') && (c <= 'f'))
+      return c - 'a' + 10;
+    else if ((c >= 'A') && (c <= 'F'))
+      return c - 'A' + 10;
+    else
+      return -1;
+}
+
+// Read the rest of a string, after its opening double quote, translating escape sequences.
+// (The characters are read directly, since comment characters are part of a string.)
+static Form *ReadString(PsilInput *input)
+{
+    long size = kMaxTokenLen, length = 0;
+    char *chars = (char *) malloc(size);
+    int c, next, digit;
+
+    if (!chars)
+      return ErrorForm("ReadString():  Failed to allocate a buffer!\n");
+
+    while (((c = InputChar(input)) != EOF) && (c != kDoubleQuote)) {
+        if (c == kBackSlash) {
+            switch (c = InputChar(input)) {
+              case 'n':  c = '\n';  break;
+              case 't':  c = '\t';  break;
+              case 'r':  c = '\r';  break;
+              case '0':  c = '\0';  break;
+              case 'a':  c = '\a';  break;
+              case 'b':  c = '\b';  break;
+              case 'f':  c = '\f';  break;
+              case 'v':  c = '\v';  break;
+              case 'e':  c = '\033';  break;
+              case 'x':
+                  // (One or two hexadecimal digits.)
+                  if ((digit = HexDigitValue(c = InputChar(input))) < 0) {
+                      UnreadChar(input, c);
+                      c = 'x';
+                      break;
+                  }
+                  c = digit;
+                  if ((digit = HexDigitValue(next = InputChar(input))) >= 0)
+                    c = c * 16 + digit;
+                  else
+                    UnreadChar(input, next);
+                  break;
+              default:
+                  // (Including a backslash or double quote, which stand for themselves.)
+                  break;
+            }
+            if (c == EOF)
+              break;
+        }
+        if (length == size) {
+            char *larger = (char *) realloc(chars, size *= 2);
+            if (!larger) {
+                free((void *) chars);
+                return ErrorForm("ReadString():  Failed to grow the buffer to %ld characters!\n", size);
+            }
+            chars = larger;
+        }
+        chars[length++] = (char) c;
+    }
+
+    if (input->file)
+      ReadEOF = (c == EOF);
+
+    Form *string = MakeString(chars, length);
+    free((void *) chars);
+
+    if (c == EOF)
+      Error("ReadString():  EOF within string!\n");
+
+    return string;
+}
+
 Form *ReadAtom(const char *token)
 {
-    int integer;
+    PsilInteger integer;
+    bool overflow = false;
     double flonum;
+    const char *end;
     Form *form;
 
     if (token == NULL) {
         return SymbolNIL;
-    } else if (ParseInteger(token, integer)) {
-        form = MakeInteger(integer);
-    } else if (ParseFlonum(token, flonum)) {
+    } else if (!NumberDigits(token, end = token + strlen(token))) {
+        // (Most tokens are symbols.)
+        form = Intern(token);
+    } else if (ParseInteger(token, end, integer, overflow)) {
+        form = overflow ? ReadBignum(token) : MakeInteger(integer);
+    } else if (ParseFlonum(token, end, flonum)) {
         form = MakeFlonum(flonum);
     } else {
         form = Intern(token);
@@ -294,92 +521,157 @@ Form *ReadAtom(const char *token)
 }
 
 
-Form *ReadList(FILE *instream)
+// Add the form to the end of the innermost list being read, or return it, if it is complete.
+// (Quoted forms are completed, and their quotes added to the lists containing them in turn.)
+static bool AddReadForm(Form **form, int *depth)
 {
-    char token[kMaxTokenLen], c;
-    ReadLevel++;
+    while (*depth > 0) {
+        ReadFrame *frame = &ReadFrames[*depth - 1];
+        if (frame->kind == kQuote) {
+            *form = Cons(SymbolQUOTE, Cons(*form, SymbolNIL));
+            (*depth)--;
+        } else {
+            Form *cell = Cons(*form, SymbolNIL);
+            if (IsNull(frame->head))
+              frame->head = cell;
+            else
+              SetCdr(frame->tail, cell);
+            frame->tail = cell;
+            return false;
+        }
+    }
 
-    c = ReadToken(instream, token);
+    return true;
+}
 
-    DPrintf("ReadList():  ***Found token: |%s|***\n", token);
+// Returns the innermost list or vector being read as a form, after ending it.
+static Form *EndReadList(int *depth)
+{
+    ReadFrame *frame = &ReadFrames[--(*depth)];
 
-    if (c == EOF) {
-        Error("ReadList():  EOF within list!\n");
-        ReadLevel = 0;
-        return SymbolNIL;
-    } else if (c == kQuote) {
-        DPrintf("ReadList():  Encountered quote.\n");
-        // N.B.:  Need to read before consing to guarantee proper ordering.
-        Form *x = Read(instream);
-        Form *y = ReadList(instream);
-        ReadLevel--;
-        return Cons(Cons(SymbolQUOTE, Cons(x, SymbolNIL)), y);
-    } else if (c == kLeftParen) {
-        DPrintf("Sublist ReadList()...\n");
-        // Start a new sub-list.
-        // N.B.:  Need to read before consing to guarantee proper ordering.
-        Form *x = ReadList(instream);
-        Form *y = ReadList(instream);
-        ReadLevel--;
-        return Cons(x, y);
-    } else if (c == kRightParen) {
-        DPrintf("Endlist ReadList()...\n");
-        // End the current list.
-        ReadLevel--;
-        return SymbolNIL;
-    } else {
-        DPrintf("Recursive ReadList()...\n");
-        Form *result = Cons(ReadAtom(token), ReadList(instream));
-        ReadLevel--;
-        return result;
+    ReadLevel--;
+
+    return (frame->kind == kSharp) ? ListToVector(frame->head) : frame->head;
+}
+
+// Begin reading a list or vector (of kind "kLeftParen" or "kSharp"), or a quoted form ("kQuote").
+static void BeginReadFrame(char kind, int depth)
+{
+    if (depth == ReadFramesSize) {
+        long size = ReadFramesSize ? (2 * ReadFramesSize) : 64;
+        ReadFrame *frames = (ReadFrame *) realloc(ReadFrames, size * sizeof(ReadFrame));
+        if (!frames)
+          ErrorOut("Read():  Failed to grow the reader stack to %ld frames!\n", size);
+        ReadFrames = frames;
+        ReadFramesSize = size;
     }
+
+    ReadFrames[depth].kind = kind;
+    ReadFrames[depth].head = ReadFrames[depth].tail = SymbolNIL;
+
+    if (kind != kQuote)
+      ReadLevel++;
 }
 
-Form *Read(FILE *instream)
+// Read a form, keeping the lists (and quotes) being read on a stack, rather than recursing,
+//  so that the reader can read lists as long, and nested as deeply, as memory allows.
+// (Nothing is collected while reading, so the partial lists on the stack stay put.)
+Form *ReadInput(PsilInput *input)
 {
-    char token[kMaxTokenLen], c;
+    char *token, c;
+    int depth = 0;
+    Form *form;
 
-    c = ReadToken(instream, token);
+    ReadLevel = 0;
+
+    for (;;) {
+        c = ReadToken(input, &TokenBuffer, &TokenBufferSize);
+        token = TokenBuffer;
+
+        DPrintf("Read():  ***Found token: |%s|***\n", token);
+
+        // (Within a list, the characters the reader does not yet support are read as symbols.)
+        bool inList = (depth > 0) && (ReadFrames[depth - 1].kind != kQuote);
+
+        if (c == EOF) {
+            if (ReadLevel > 0) {
+                // End all of the lists being read (dropping any quote with nothing to quote.)
+                Error("ReadList():  EOF within list!\n");
+                while (ReadFrames[depth - 1].kind == kQuote)
+                  depth--;
+                form = EndReadList(&depth);
+                while (!AddReadForm(&form, &depth))
+                  form = EndReadList(&depth);
+                return form;
+            }
+            // (Running out of a string is not the end of the session.)
+            if (!input->file)
+              return ErrorForm("Read():  EOF within string!\n");
+            if (IsInteractive)
+              Message("\n");
+            longjmp(TopLevelJmpBuf, kExitInterpreter);
+        } else if ((c == kQuote) || ((c == kBackQuote) && !inList)) {
+            DPrintf("Read():  Encountered quote.\n");
+            // XXX -- Treat backquote the same as quote for now.
+            BeginReadFrame(kQuote, depth++);
+            continue;
+        } else if ((c == kLeftParen) || (c == kSharp)) {
+            BeginReadFrame(c, depth++);
+            continue;
+        } else if (c == kRightParen) {
+            if (inList) {
+                form = EndReadList(&depth);
+            } else {
+                // XXX -- Need to handle error conditions better than this.
+                Error("Read():  Read ')' outside of list!\n");
+                form = SymbolNIL;
+            }
+        } else if (c == kDoubleQuote) {
+            form = ReadString(input);
+        } else if ((c == kAtSign) && !inList) {
+            DPrintf("Read():  Encountered atsign.\n");
+            Error("Read():  Read '@' -- Not yet supported!\n");
+            form = SymbolNIL;
+        } else if ((c == kColon) && !inList) {
+            DPrintf("Read():  Encountered colon.\n");
+            if (ReadLevel == 0) {
+                char cmd_line[kMaxTokenLen];
+                form = DoCommand(ReadCommand(input, cmd_line)) ? SymbolT : SymbolNIL;
+            } else {
+                // Handle colon as a normal symbol character.
+                // XXX -- TBD.
+                Error("Read():  Read ':' not at top level (%d) ~~ Not yet supported!\n", ReadLevel);
+                form = SymbolNIL;
+            }
+        } else
+          form = ReadAtom(token);
+
+        if (AddReadForm(&form, &depth))
+          return form;
+    }
+}
 
-    if (c == EOF) {
-        if (IsInteractive)
-          Message("\n");
-        longjmp(TopLevelJmpBuf, kExitInterpreter);
+// Read a form from the file, through an input buffering it.
+// (Only the reader may read from the file, since it reads ahead into its buffer.)
+Form *Read(FILE *instream)
+{
+    if (!FileInput || (FileInput->file != instream)) {
+        CloseInput(FileInput);
+        FileInput = OpenInputFile(instream);
     }
 
-    DPrintf("Read():  ***Found token: |%s|***\n", token);
+    return ReadInput(FileInput);
+}
 
-    if (!strcasecmp(token, "NIL"))
-      return SymbolNIL;
+// Read the first form in the string.
+Form *ReadFromString(Form *string)
+{
+    if (!IsString(string))
+      return ErrorForm("ReadFromString():  Non-string argument!\n");
 
-    if (c == kQuote) {
-        DPrintf("Read():  Encountered quote.\n");
-        return Cons(SymbolQUOTE, Cons(Read(instream), SymbolNIL));
-    } else if (c == kLeftParen) {
-        return ReadList(instream);
-    } else if (c == kRightParen) {
-        // XXX -- Need to handle error conditions better than this.
-        Error("Read():  Read ')' outside of list!\n");
-        return SymbolNIL;
-    } else if (c == kBackQuote) {
-        DPrintf("Read():  Encountered backquote.\n");
-        // XXX -- Treat the same as quote for now.
-        return Cons(SymbolQUOTE, Cons(Read(instream), SymbolNIL));
-    } else if (c == kAtSign) {
-        DPrintf("Read():  Encountered atsign.\n");
-        Error("Read():  Read '@' -- Not yet supported!\n");
-        return SymbolNIL;
-    } else if (c == kColon) {
-        DPrintf("Read():  Encountered colon.\n");
-        if (ReadLevel == 0) {
-            char cmd_line[kMaxTokenLen];
-            return DoCommand(ReadCommand(instream, cmd_line)) ? SymbolT : SymbolNIL;
-        } else {
-            // Handle colon as a normal symbol character.
-            // XXX -- TBD.
-            Error("Read():  Read ':' not at top level (%d) ~~ Not yet supported!\n", ReadLevel);
-            return SymbolNIL;
-        }
-    } else
-      return ReadAtom(token);
+    // (The previous string's input is only released now, since reading may have escaped via an error.)
+    CloseInput(StringInput);
+    StringInput = OpenInputString(StringValue(string), StringLength(string));
+
+    return ReadInput(StringInput);
 }
@@ -0,0 +1,183 @@
+/*
+    File:   Resolver.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 14:05:12 2026
+
+    Description:
+       Psil lexical address resolver.
+
+       When a closure is made, the variable references in its body are
+       resolved to their lexical addresses, i.e., the number of bindings
+       between the body's environment and the variable's binding, so that
+       looking one up is just that many pointer hops rather than a search
+       comparing names.
+
+       This works because the shape of a closure body's environment is
+       known when the closure is made:  It is the arguments (bound last
+       to first) on top of the captured environment, whose bindings never
+       change shape, only value.  Within the body, nested lambda forms add
+       their arguments.  Nested lambda forms are resolved along with the
+       body, and are marked with the uninterned symbol
+       "SymbolResolvedLAMBDA" so they are not resolved again.
+
+       References which are not bound when the closure is made, i.e.,
+       references to globals (which are kept in symbols' value cells rather
+       than in environments), are left as symbols, as are quoted forms.
+       A global in the function position of a call is replaced by a call
+       site, which caches the function until any global is next set.
+*/
+
+
+// Include declarations files.
+
+
+#include <string.h>
+#include "Psil.h"
+
+
+// Define types.
+
+
+// The names bound within the body being resolved, innermost first.
+typedef struct Scope {
+    Form  *name;
+    Scope *parent;
+} Scope;
+
+
+// Define functions.
+
+
+static Form *Resolve(Form *form, Scope *scope, Environment *env);
+
+// Returns the lexical address of the symbol, or -1 if it is not bound.
+static long FindDepth(Form *symbol, Scope *scope, Environment *env)
+{
+    const char *name = SymbolName(symbol);
+    long depth = 0;
+
+    for ( ; scope; scope = scope->parent, depth++)
+      if (!strcasecmp(name, SymbolName(scope->name)))
+        return depth;
+
+    for ( ; env; env = env->parent, depth++)
+      if (!strcasecmp(name, env->name))
+        return depth;
+
+    return -1;
+}
+
+// Returns whether the arglist is a proper list of symbols, as "BindArgs()" requires.
+bool IsValidArglist(Form *arglist)
+{
+    while (IsCons(arglist)) {
+        if (!IsSymbol(Car(arglist)))
+          return false;
+        arglist = Cdr(arglist);
+    }
+
+    return IsNull(arglist);
+}
+
+// Resolve each form of a list.
+static Form *ResolveList(Form *list, Scope *scope, Environment *env)
+{
+    Form *head = SymbolNIL, *tail = SymbolNIL;
+
+    while (IsCons(list)) {
+        Form *cell = Cons(Resolve(Car(list), scope, env), SymbolNIL);
+        if (IsNull(head))
+          head = cell;
+        else
+          SetCdr(tail, cell);
+        tail = cell;
+        list = Cdr(list);
+    }
+
+    // (Keep the tail of an improper list.)
+    if (!IsNull(list)) {
+        if (IsNull(head))
+          return list;
+        SetCdr(tail, list);
+    }
+
+    return head;
+}
+
+// Resolve a body within the scope of its arguments.
+// (Arguments are bound in order, so the last one is innermost.)
+static Form *ResolveArgs(Form *arglist, Form *body, Scope *scope, Environment *env)
+{
+    if (IsNull(arglist))
+      return ResolveList(body, scope, env);
+
+    Scope arg = {Car(arglist), scope};
+
+    return ResolveArgs(Cdr(arglist), body, &arg, env);
+}
+
+// Resolve a nested lambda form.
+static Form *ResolveLambda(Form *form, Scope *scope, Environment *env)
+{
+    Form *arglist = Cadr(form);
+
+    if (!IsValidArglist(arglist))
+      return form;
+
+    return Cons(SymbolResolvedLAMBDA, Cons(arglist, ResolveArgs(arglist, Cddr(form), scope, env)));
+}
+
+// Resolve a function call, giving a global function a call site.
+static Form *ResolveCall(Form *form, Scope *scope, Environment *env)
+{
+    Form *func = Car(form);
+
+    if (IsSymbol(func) && !IsNull(func) && (FindDepth(func, scope, env) < 0))
+      return Cons(MakeCallSite(func), ResolveList(Cdr(form), scope, env));
+
+    return ResolveList(form, scope, env);
+}
+
+// Resolve a form in the same way that "Eval()" would evaluate it.
+static Form *Resolve(Form *form, Scope *scope, Environment *env)
+{
+    if (IsNull(form))
+      return form;
+    else if (IsSymbol(form)) {
+        long depth = FindDepth(form, scope, env);
+        return (depth < 0) ? form : MakeLocal(form, depth);
+    } else if (!IsCons(form))
+      return form;
+
+    Form *car = Car(form);
+
+    if (IsQuote(car) || IsResolvedLambda(car))
+      return form;
+    else if (IsIf(car))
+      return Cons(car, ResolveList(Cdr(form), scope, env));
+    else if (IsLambda(car))
+      return ResolveLambda(form, scope, env);
+    else if (IsAssignment(form) || IsDefinition(form))
+      return Cons(car, ResolveList(Cdr(form), scope, env));
+    else
+      return ResolveCall(form, scope, env);
+}
+
+// Returns a copy of the body of a closure to be made in the environment,
+//  with its variable references resolved to lexical addresses.
+// (This does not evaluate anything, so it is not a safe point.)
+Form *ResolveBody(Form *arglist, Form *body, Environment *env)
+{
+    if (!IsValidArglist(arglist))
+      return body;
+
+    Form *resolvedBody = ResolveArgs(arglist, body, NULL, env);
+
+    if (TraceEvaluator) {
+        fprintf(StandardError, "\tResolveBody() ==> ");
+        Print(resolvedBody, StandardError);
+        fprintf(StandardError, "\n");
+    }
+
+    return resolvedBody;
+}
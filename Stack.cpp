@@ -90,3 +90,18 @@ Form *Pop(void)
     else
       return ErrorForm("Pop():  Stack underflow!\n");
 }
+
+// Returns the form "depth" below the top of the stack (i.e., 0 is the top.)
+Form *Peek(int depth)
+{
+    if ((depth < 0) || (depth >= SP))
+      return ErrorForm("Peek():  Stack underflow!\n");
+    else
+      return Stack[SP - 1 - depth];
+}
+
+void VisitStack(FormVisitor *visitor)
+{
+    for (int sp = 0; sp < SP; sp++)
+      visitor(&Stack[sp]);
+}
@@ -0,0 +1,108 @@
+/*
+    File:   String.cpp
+    Author: ***PSI***
+    Date:   Mon Oct 19 02:17:45 2026
+
+    Description:
+       Psil string functions.
+
+       Strings know their length, so none of these need to scan for the
+       terminating NUL, and strings may contain NULs themselves.
+
+       Searching uses the C library's "memchr()" for a single character,
+       and "memmem()" otherwise, which (e.g., in glibc) are vectorized, and
+       use the linear time Two-Way algorithm for longer patterns.
+*/
+
+
+// Include declarations files.
+
+
+#include <string.h>
+#include "Psil.h"
+
+
+// Define functions.
+
+
+Form *StringEqual(Form *x, Form *y)
+{
+    if (!IsString(x) || !IsString(y))
+      return ErrorForm("StringEqual():  Non-string argument(s)!\n");
+
+    return ((StringLength(x) == StringLength(y)) && !memcmp(StringValue(x), StringValue(y), StringLength(x)))
+      ? SymbolT : SymbolNIL;
+}
+
+// Returns the index as a position within the string, after checking that it is one.
+static long StringIndex(const char *name, Form *string, Form *index)
+{
+    if (!IsInteger(index) || (IntegerValue(index) < 0) || (IntegerValue(index) > StringLength(string))) {
+        ErrorForm("%s():  Index out of bounds (length %ld)!\n", name, StringLength(string));
+        return 0;
+    }
+
+    return (long) IntegerValue(index);
+}
+
+// Returns the characters of the string from "start" up to "end", or to the end of the string if "end" is NIL.
+Form *Substring(Form *string, Form *start, Form *end)
+{
+    if (!IsString(string))
+      return ErrorForm("Substring():  Non-string argument!\n");
+
+    long first = StringIndex("Substring", string, start);
+    long last = IsNull(end) ? StringLength(string) : StringIndex("Substring", string, end);
+
+    if (last < first)
+      return ErrorForm("Substring():  End %ld is before start %ld!\n", last, first);
+
+    return MakeString(StringValue(string) + first, last - first);
+}
+
+// Pops the top "nargs" strings on the stack, and returns their concatenation, in the order they were pushed.
+Form *StringAppend(long nargs)
+{
+    long length = 0;
+
+    for (long index = 0; index < nargs; index++) {
+        Form *string = Peek(index);
+        if (!IsString(string)) {
+            RestoreStack(SaveStack() - nargs);
+            return ErrorForm("StringAppend():  Non-string argument!\n");
+        }
+        length += StringLength(string);
+    }
+
+    // (Nothing can be collected while the result is made, so the arguments stay put.)
+    Form *result = MakeString(NULL, length);
+    char *chars = (char *) StringValue(result) + length;
+
+    for (long index = 0; index < nargs; index++) {
+        Form *string = Pop();
+        chars -= StringLength(string);
+        memcpy(chars, StringValue(string), StringLength(string));
+    }
+
+    return result;
+}
+
+// Returns the index of the first occurrence of "pattern" in "string" at or after "start" (or 0 if NIL), or NIL.
+Form *StringSearch(Form *pattern, Form *string, Form *start)
+{
+    if (!IsString(pattern) || !IsString(string))
+      return ErrorForm("StringSearch():  Non-string argument(s)!\n");
+
+    long from = IsNull(start) ? 0 : StringIndex("StringSearch", string, start);
+    const char *chars = StringValue(string) + from, *found;
+    long length = StringLength(string) - from, patternLength = StringLength(pattern);
+
+    if (patternLength == 0)
+      return MakeInteger(from);
+    else if (patternLength == 1)
+      found = (const char *) memchr(chars, *StringValue(pattern), length);
+    else
+      found = (const char *) memmem(chars, length, StringValue(pattern), patternLength);
+
+    return found ? MakeInteger(found - StringValue(string)) : SymbolNIL;
+}
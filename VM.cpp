@@ -0,0 +1,309 @@
+/*
+    File:   VM.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 17:02:31 2026
+
+    Description:
+       Psil virtual machine.
+
+       Executes the code compiled by "Compiler.cpp", using the Psil stack
+       for operands.  A function call leaves the function and its arguments
+       on the stack, with the first argument deepest, and replaces them
+       with the function's value.  Closures with compiled code are bound
+       and executed directly by the machine; anything else is handed to
+       "Apply()" with its (already evaluated) arguments quoted.
+
+       A call in tail position to a compiled closure replaces the current
+       frame:  Its bindings are released and its code is jumped to, so
+       iteration by tail recursion runs in constant C stack.
+
+       Calls are the machine's safe points for garbage collection, so the
+       environment is protected, and values are only kept on the stack
+       across them.  (Code is never moved by the collector.)
+*/
+
+
+// Include declarations files.
+
+
+#include "Psil.h"
+
+
+// Define constants.
+
+
+// Dispatch instructions by computed "goto" where the compiler supports it.
+#if defined(__GNUC__) && !defined(NO_THREADED_DISPATCH)
+#define THREADED_DISPATCH 1
+#else
+#define THREADED_DISPATCH 0
+#endif // defined(__GNUC__) && !defined(NO_THREADED_DISPATCH)
+
+// The number of operands following each opcode.
+static const int kNumOperands[kNumPsilOpcodes] = {
+    1,  // kOpConstant
+    1,  // kOpLocal
+    1,  // kOpGlobal
+    1,  // kOpSetLocal
+    1,  // kOpSetGlobal
+    0,  // kOpPop
+    1,  // kOpJump
+    1,  // kOpJumpIfNil
+    1,  // kOpCall
+    1,  // kOpTailCall
+    1,  // kOpClosure
+    1,  // kOpEval
+    0   // kOpReturn
+};
+
+
+// Define macros.
+
+
+// Note:  With threaded dispatch, the opcodes of code are replaced by the
+//        addresses of their handlers the first time the code is executed,
+//        and each handler ends by jumping directly to the next one's.
+//        Otherwise, each handler returns to a central "switch".
+#if THREADED_DISPATCH
+#define LOAD_CODE()       (pcode = CodeValue(code), \
+                           (pcode->threaded ? (void) 0 : Thread(pcode, handlers)), \
+                           ops = pcode->ops, constants = pcode->constants)
+#define DISPATCH_BEGIN    goto *(const void *) ops[pc++]; {
+#define DISPATCH_END      }
+#define OPCODE(opcode)    Do_##opcode:
+#define NEXT              goto *(const void *) ops[pc++]
+#else
+#define LOAD_CODE()       (pcode = CodeValue(code), ops = pcode->ops, constants = pcode->constants)
+#define DISPATCH_BEGIN    for (;;) switch (ops[pc++]) {
+#define DISPATCH_END        default: \
+                              ErrorOut("Execute():  Invalid opcode: %ld at %ld!\n", ops[pc - 1], pc - 1); \
+                          }
+#define OPCODE(opcode)    case opcode:
+#define NEXT              continue
+#endif // THREADED_DISPATCH
+
+
+// Define global variables.
+
+
+// Whether closures are compiled to code for the virtual machine.
+bool UseVM = false;
+
+
+// Define functions.
+
+
+#if THREADED_DISPATCH
+// Replace the opcodes of the code by the addresses of their handlers.
+static void Thread(PsilCode *pcode, const void *const *handlers)
+{
+    long pc = 0;
+
+    while (pc < pcode->numOps) {
+        long opcode = pcode->ops[pc];
+        pcode->ops[pc] = (long) handlers[opcode];
+        pc += 1 + kNumOperands[opcode];
+    }
+
+    pcode->threaded = true;
+}
+#endif // THREADED_DISPATCH
+
+// Bind the arguments of the closure below them on the stack, then pop them.
+static Environment *BindStackArgs(long nargs)
+{
+    Form *func = Peek(nargs);
+    Form *arglist = LambdaArglist(func);
+    Environment *env = LambdaEnvironment(func);
+    long index = nargs;
+
+    for ( ; !IsNull(arglist) && index; arglist = Cdr(arglist), index--)
+      env = Bind(SymbolName(Car(arglist)), Peek(index - 1), env);
+
+    if (index)
+      Error("Execute():  Ignoring extra arguments!\n");
+    else if (!IsNull(arglist)) {
+        Error("Execute():  Binding missing arguments to NIL!\n");
+        for ( ; !IsNull(arglist); arglist = Cdr(arglist))
+          env = Bind(SymbolName(Car(arglist)), SymbolNIL, env);
+    }
+
+    RestoreStack(SaveStack() - nargs);
+
+    return env;
+}
+
+// Apply the function below its arguments on the stack, replacing them with its value.
+static void Call(long nargs, Environment *env)
+{
+    Form *func = Peek(nargs), *retval;
+    int roots = SaveRoots();
+
+    // (The caller's bindings may be moved by a collection in the callee, and are restored afterwards.)
+    ProtectEnvironment(&env);
+
+    if (IsFunc(func)) {
+        PsilFunc *pfunc = FuncValue(func);
+        if ((nargs != pfunc->nargs) && (pfunc->nargs != kVariadicArgs))
+          ErrorForm("Call():  Incorrect number of arguments to function \"%s\": Supplied: %ld; Expected: %d\n", pfunc->name, nargs, pfunc->nargs);
+        retval = CallPrimitive(pfunc, nargs);
+    } else if (IsClosure(func) && LambdaCode(func)) {
+        // (The closure stays on the stack, to keep its environment, until it returns.)
+        unsigned long epoch = EnvironmentEpoch;
+        Environment *funcEnv = BindStackArgs(nargs);
+        ProtectEnvironment(&funcEnv);
+        CurrentEnv = funcEnv;
+        retval = Execute(LambdaCode(Peek(0)), funcEnv);
+        CurrentEnv = env;
+        ReleaseEnvironment(funcEnv, LambdaEnvironment(Peek(0)), epoch);
+    } else {
+        Form *args = SymbolNIL;
+        for (long index = 0; index < nargs; index++)
+          args = Cons(Cons(SymbolQUOTE, Cons(Pop(), SymbolNIL)), args);
+        ProtectForm(&args);
+        retval = Apply(Peek(0), args, env);
+    }
+
+    Pop();
+    Push(retval);
+
+    RestoreRoots(roots);
+}
+
+// Returns the value of executing the code in the environment.
+Form *Execute(Form *code, Environment *env)
+{
+    // The bindings of the closure most recently called in tail position, if any.
+    Environment *callerEnv = env, *frameEnv = NULL, *frameParent = NULL;
+    unsigned long frameEpoch = 0;
+    int roots = SaveRoots();
+    int sp = SaveStack();
+
+    if (TraceEvaluator) {
+        fprintf(StandardError, "EVAL:  Execute(");
+        Print(code, StandardError);
+        fprintf(StandardError, ", ");
+        PrintEnvironment(env, StandardError, TraceEnvironment);
+        fprintf(StandardError, ")\n");
+    }
+
+    ProtectForm(&code);
+    ProtectEnvironment(&env);
+    ProtectEnvironment(&callerEnv);
+    ProtectEnvironment(&frameEnv);
+    ProtectEnvironment(&frameParent);
+
+    PsilCode *pcode;
+    const long *ops;
+    Form **constants;
+    long pc = 0;
+
+#if THREADED_DISPATCH
+    // The handler of each opcode, in the order of "PsilOpcode".
+    static const void *const handlers[kNumPsilOpcodes] = {
+        &&Do_kOpConstant, &&Do_kOpLocal, &&Do_kOpGlobal, &&Do_kOpSetLocal,
+        &&Do_kOpSetGlobal, &&Do_kOpPop, &&Do_kOpJump, &&Do_kOpJumpIfNil,
+        &&Do_kOpCall, &&Do_kOpTailCall, &&Do_kOpClosure, &&Do_kOpEval,
+        &&Do_kOpReturn
+    };
+#endif // THREADED_DISPATCH
+
+    LOAD_CODE();
+
+    DISPATCH_BEGIN
+
+      OPCODE(kOpConstant)
+        Push(constants[ops[pc++]]);
+        NEXT;
+
+      OPCODE(kOpLocal)
+        Push(LookupLocal(constants[ops[pc++]], env));
+        NEXT;
+
+      OPCODE(kOpGlobal)
+        Push(Lookup(constants[ops[pc++]], NULL));
+        NEXT;
+
+      OPCODE(kOpSetLocal)
+        SetLocal(constants[ops[pc++]], Peek(0), env);
+        NEXT;
+
+      OPCODE(kOpSetGlobal)
+        SetSymbolValue(constants[ops[pc++]], Peek(0));
+        NEXT;
+
+      OPCODE(kOpPop)
+        Pop();
+        NEXT;
+
+      OPCODE(kOpJump)
+        pc = ops[pc];
+        NEXT;
+
+      OPCODE(kOpJumpIfNil)
+        if (Pop() == SymbolNIL)
+          pc = ops[pc];
+        else
+          pc++;
+        NEXT;
+
+      OPCODE(kOpCall)
+        // This is a safe point for garbage collection.
+        if (GCRequested)
+          GCSafePoint();
+        Call(ops[pc++], env);
+        NEXT;
+
+      OPCODE(kOpTailCall) {
+          long nargs = ops[pc++];
+          // This is a safe point for garbage collection.
+          if (GCRequested)
+            GCSafePoint();
+          Form *func = Peek(nargs);
+          if (!IsClosure(func) || !LambdaCode(func)) {
+              // (The return follows.)
+              Call(nargs, env);
+              NEXT;
+          }
+          unsigned long epoch = EnvironmentEpoch;
+          Environment *funcEnv = BindStackArgs(nargs);
+          func = Pop();
+          // The arguments have been evaluated, so the previous frame's bindings are dead.
+          if (frameEnv)
+            ReleaseEnvironment(frameEnv, frameParent, frameEpoch);
+          frameEnv = funcEnv;
+          frameParent = LambdaEnvironment(func);
+          frameEpoch = epoch;
+          env = CurrentEnv = funcEnv;
+          code = LambdaCode(func);
+          LOAD_CODE();
+          pc = 0;
+          NEXT;
+      }
+
+      OPCODE(kOpClosure) {
+          PsilCode *closureCode = CodeValue(constants[ops[pc++]]);
+          Form *closure = MakeClosure(closureCode->arglist, closureCode->body, env);
+          Push(SetLambdaCode(closure, constants[ops[pc - 1]]));
+          NEXT;
+      }
+
+      OPCODE(kOpEval)
+        Push(Eval(constants[ops[pc++]], env));
+        NEXT;
+
+      OPCODE(kOpReturn) {
+          Form *retval = Pop();
+          // (A compiler bug, but the top level restores the stack, so the session can go on.)
+          if (SaveStack() != sp)
+            ErrorForm("Execute():  Stack imbalance: %d != %d!\n", SaveStack(), sp);
+          if (frameEnv) {
+              CurrentEnv = callerEnv;
+              ReleaseEnvironment(frameEnv, frameParent, frameEpoch);
+          }
+          RestoreRoots(roots);
+          return retval;
+      }
+
+    DISPATCH_END
+}
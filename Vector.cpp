@@ -0,0 +1,157 @@
+/*
+    File:   Vector.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 23:41:07 2026
+
+    Description:
+       Psil simple vectors.
+
+       A vector holds any forms in one contiguous block, so referencing or
+       setting an element by position is constant time, rather than a walk
+       down a list.
+
+       Vectors are allocated in the old generation, so storing a young form
+       into one must go through the write barrier, as for code constants.
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include "Psil.h"
+
+
+// Define constants.
+
+
+// The most elements a vector may have.
+static const long kMaxVectorLength = 1L << 32;
+
+
+// Define functions.
+
+
+// Returns a new vector of "length" elements, each initially "fill".
+static Form *NewVector(long length, Form *fill)
+{
+    Form **elements = (Form **) malloc((length ? length : 1) * sizeof(Form *));
+    Form *form;
+
+    if (!elements)
+      return ErrorForm("MakeVector():  Failed to allocate %ld elements!\n", length);
+
+    if ((form = AllocateForm(kPsilVector)) == NULL) {
+        free((void *) elements);
+        return ErrorForm("MakeVector():  AllocateForm() failed!\n");
+    }
+
+    for (long index = 0; index < length; index++)
+      elements[index] = fill;
+
+    form->value.vector.elements = elements;
+    form->value.vector.length = length;
+    AddExternalBytes(length * sizeof(Form *));
+
+    if (length)
+      WriteBarrier(form, fill);
+
+    return form;
+}
+
+Form *MakeVector(Form *length, Form *fill)
+{
+    if (!IsInteger(length) || (IntegerValue(length) < 0))
+      return ErrorForm("MakeVector():  Length must be a non-negative integer!\n");
+    else if (IntegerValue(length) > kMaxVectorLength)
+      return ErrorForm("MakeVector():  Too many elements!\n");
+
+    return NewVector((long) IntegerValue(length), fill);
+}
+
+// Pops the top "nargs" forms on the stack into a new vector, in the order they were pushed.
+Form *PopVector(long nargs)
+{
+    Form *form = NewVector(nargs, SymbolNIL);
+    Form **elements = VectorValue(form)->elements;
+
+    for (long index = nargs - 1; index >= 0; index--) {
+        elements[index] = Pop();
+        WriteBarrier(form, elements[index]);
+    }
+
+    return form;
+}
+
+// Returns the index, after checking that it is in bounds.
+static long ElementIndex(const char *name, Form *vector, Form *index)
+{
+    if (!IsVector(vector)) {
+        ErrorForm("%s():  Non-vector argument!\n", name);
+        return 0;
+    }
+
+    if (!IsInteger(index) || (IntegerValue(index) < 0) || (IntegerValue(index) >= VectorValue(vector)->length)) {
+        ErrorForm("%s():  Index out of bounds (length %ld)!\n", name, VectorValue(vector)->length);
+        return 0;
+    }
+
+    return (long) IntegerValue(index);
+}
+
+Form *VectorRef(Form *vector, Form *index)
+{
+    return VectorValue(vector)->elements[ElementIndex("VectorRef", vector, index)];
+}
+
+Form *VectorSet(Form *vector, Form *index, Form *value)
+{
+    VectorValue(vector)->elements[ElementIndex("VectorSet", vector, index)] = value;
+    WriteBarrier(vector, value);
+
+    return value;
+}
+
+Form *VectorLength(Form *vector)
+{
+    if (!IsVector(vector))
+      return ErrorForm("VectorLength():  Non-vector argument!\n");
+
+    return MakeInteger(VectorValue(vector)->length);
+}
+
+Form *ListToVector(Form *list)
+{
+    long length = 0;
+    Form *tail;
+
+    for (tail = list; IsCons(tail); tail = Cdr(tail))
+      length++;
+
+    if (!IsNull(tail))
+      return ErrorForm("ListToVector():  Non-list argument!\n");
+
+    Form *form = NewVector(length, SymbolNIL);
+    Form **elements = VectorValue(form)->elements;
+
+    for (long index = 0; index < length; index++, list = Cdr(list)) {
+        elements[index] = Car(list);
+        WriteBarrier(form, elements[index]);
+    }
+
+    return form;
+}
+
+Form *VectorToList(Form *vector)
+{
+    if (!IsVector(vector))
+      return ErrorForm("VectorToList():  Non-vector argument!\n");
+
+    Form *list = SymbolNIL;
+
+    // (Consing does not collect, so the vector's elements stay put.)
+    for (long index = VectorValue(vector)->length - 1; index >= 0; index--)
+      list = Cons(VectorValue(vector)->elements[index], list);
+
+    return list;
+}
@@ -0,0 +1,135 @@
+/*
+    File:   BignumBench.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 20:27:49 2026
+
+    Description:
+       Benchmark of bignum multiplication and decimal conversion.
+
+       Computes factorial(10000) by repeated multiplication with the
+       arithmetic primitives, and (expt 3 100000) by repeated squaring,
+       first with schoolbook multiplication only and then with Karatsuba
+       multiplication above its threshold, and times converting each
+       result to decimal.
+
+       Usage:  bignum-bench [<Factorial> [<Power of 3>]]
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/time.h>
+#include "../Psil.h"
+
+
+// Define constants.
+
+
+static const long kDefaultFactorial = 10000;
+static const long kDefaultPower = 100000;
+
+
+// Define global variables.
+
+
+// (These are normally defined by the interpreter's "Psil.cpp".)
+FILE *StandardInput  = NULL;
+FILE *StandardOutput = NULL;
+FILE *StandardError  = NULL;
+
+jmp_buf TopLevelJmpBuf;
+
+bool IsInteractive = false;
+
+
+// Define functions.
+
+
+static double ElapsedMilliseconds(struct timeval *start)
+{
+    struct timeval end;
+
+    gettimeofday(&end, NULL);
+
+    return (end.tv_sec - start->tv_sec) * 1.0e3 + (end.tv_usec - start->tv_usec) * 1.0e-3;
+}
+
+// Returns n!, computed by the "*" primitive.
+static Form *Factorial(long n)
+{
+    Form *product = MakeInteger(1);
+    int roots = SaveRoots();
+
+    ProtectForm(&product);
+
+    for (long i = 2; i <= n; i++) {
+        product = Times(MakeInteger(i), product);
+        // (Nothing is evaluated, so collect when requested to free the intermediate products.)
+        if (GCRequested)
+          CollectGarbage();
+    }
+
+    RestoreRoots(roots);
+
+    return product;
+}
+
+// Time computing the value and converting it to decimal, printing the results.
+static void Run(const char *name, long argument, bool factorial, long threshold)
+{
+    struct timeval start;
+    double computeTime, printTime;
+
+    KaratsubaThreshold = threshold;
+
+    gettimeofday(&start, NULL);
+    Form *value = factorial ? Factorial(argument) : Expt(MakeInteger(3), MakeInteger(argument));
+    computeTime = ElapsedMilliseconds(&start);
+
+    gettimeofday(&start, NULL);
+    char *digits = BignumToString(value);
+    printTime = ElapsedMilliseconds(&start);
+
+    printf("%-16s %-10s %10ld %12.2f %12.2f   %.10s...\n", name, (threshold == LONG_MAX) ? "schoolbook" : "karatsuba",
+           (long) strlen(digits), computeTime, printTime, digits);
+
+    free((void *) digits);
+}
+
+int main(int argc, char *argv[])
+{
+    long n = (argc > 1) ? atol(argv[1]) : kDefaultFactorial;
+    long power = (argc > 2) ? atol(argv[2]) : kDefaultPower;
+    long threshold = KaratsubaThreshold;
+    char name[64];
+
+    StandardInput = stdin;
+    StandardOutput = stdout;
+    StandardError = stderr;
+
+    if ((InitializeHeap(0) != kPsilOK) || (InitializeReader() != kPsilOK))
+      ErrorOut("BignumBench:  Initialization failed!\n");
+
+    if (setjmp(TopLevelJmpBuf))
+      ErrorOut("BignumBench:  Arithmetic failed!\n");
+
+    printf("%-16s %-10s %10s %12s %12s\n", "Computation", "Multiply", "Digits", "Compute (ms)", "Print (ms)");
+
+    snprintf(name, sizeof(name), "factorial(%ld)", n);
+    Run(name, n, true, LONG_MAX);
+    Run(name, n, true, threshold);
+
+    snprintf(name, sizeof(name), "(expt 3 %ld)", power);
+    Run(name, power, false, LONG_MAX);
+    Run(name, power, false, threshold);
+
+    DeInitializeReader();
+    DeInitializeHeap();
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+    File:   LookupBench.cpp
+    Author: ***PSI***
+    Date:   Sun Oct 18 14:52:20 2026
+
+    Description:
+       Benchmark of variable lookup cost versus environment depth.
+
+       For each depth, a variable is bound that many bindings below the
+       top of an environment, and it is looked up repeatedly both by name
+       (i.e., evaluating its symbol) and by lexical address (i.e.,
+       evaluating the reference the resolver makes for it.)
+
+       Usage:  lookup-bench [<Iterations>]
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include "../Psil.h"
+
+
+// Define constants.
+
+
+static const long kDefaultIterations = 1000000;
+
+static const int kDepths[] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 0};
+
+
+// Define global variables.
+
+
+// (These are normally defined by the interpreter's "Psil.cpp".)
+FILE *StandardInput  = NULL;
+FILE *StandardOutput = NULL;
+FILE *StandardError  = NULL;
+
+jmp_buf TopLevelJmpBuf;
+
+bool IsInteractive = false;
+
+// (Keeps the lookups from being optimized away.)
+volatile Form *Sink;
+
+
+// Define functions.
+
+
+static double ElapsedNanoseconds(struct timeval *start)
+{
+    struct timeval end;
+
+    gettimeofday(&end, NULL);
+
+    return (end.tv_sec - start->tv_sec) * 1.0e9 + (end.tv_usec - start->tv_usec) * 1.0e3;
+}
+
+// Returns the average time of evaluating the form, in nanoseconds.
+static double TimeEval(Form *form, Environment *env, long iterations)
+{
+    struct timeval start;
+
+    gettimeofday(&start, NULL);
+
+    for (long iteration = 0; iteration < iterations; iteration++)
+      Sink = Eval(form, env);
+
+    return ElapsedNanoseconds(&start) / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    long iterations = (argc > 1) ? atol(argv[1]) : kDefaultIterations;
+
+    StandardInput = stdin;
+    StandardOutput = stdout;
+    StandardError = stderr;
+
+    if ((InitializeHeap(0) != kPsilOK) || (InitializeReader() != kPsilOK))
+      ErrorOut("LookupBench:  Initialization failed!\n");
+
+    if (setjmp(TopLevelJmpBuf))
+      ErrorOut("LookupBench:  Lookup failed!\n");
+
+    Environment *topLevelEnv = InitializeEnvironment();
+    Form *symbol = Intern("X");
+    Form *filler = Intern("V");
+
+    printf("%8s %16s %16s %10s\n", "Depth", "By Name (ns)", "By Address (ns)", "Speedup");
+
+    for (const int *depth = kDepths; *depth; depth++) {
+        // Bind "X", then bury it under the other bindings.
+        Environment *env = Bind(SymbolName(symbol), MakeInteger(*depth), topLevelEnv);
+
+        for (int index = 1; index < *depth; index++)
+          env = Bind(SymbolName(filler), SymbolNIL, env);
+
+        Form *local = MakeLocal(symbol, *depth - 1);
+
+        if (Eval(symbol, env) != Eval(local, env))
+          ErrorOut("LookupBench:  Lookups disagree at depth %d!\n", *depth);
+
+        double byName = TimeEval(symbol, env, iterations);
+        double byAddress = TimeEval(local, env, iterations);
+
+        printf("%8d %16.2f %16.2f %9.1fx\n", *depth, byName, byAddress, byName / byAddress);
+    }
+
+    DeInitializeReader();
+    DeInitializeHeap();
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*
+    File:   ReaderBench.cpp
+    Author: ***PSI***
+    Date:   Mon Oct 19 05:12:33 2026
+
+    Description:
+       Benchmark of reader throughput.
+
+       Generates a file of the given size of nested s-expressions (of
+       symbols, integers, flonums, strings, quoted forms and comments),
+       then times tokenizing the whole file, and reading it as forms, in
+       megabytes per second.
+
+       Then times printing a list of the given number of random flonums
+       and integers, i.e., a numeric data dump, and reading it back, and
+       checks that it reads back exactly.
+
+       Build with -DNO_SIMD in CFLAGS to compare with the scalar scanner.
+
+       Usage:  reader-bench [<Megabytes> [<Numbers>]]
+*/
+
+
+// Include declarations files.
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "../Psil.h"
+
+
+// Define constants.
+
+
+static const long kDefaultMegabytes = 64;
+
+static const long kDefaultNumbers = 1000000;
+
+static const int kMaxDepth = 6;
+
+static const char *kSymbols[] = {"define", "lambda", "if", "car", "cdr", "cons", "x", "y",
+                                 "accumulate-total", "vector-ref", "string-append", "*", NULL};
+
+
+// Define global variables.
+
+
+// (These are normally defined by the interpreter's "Psil.cpp".)
+FILE *StandardInput  = NULL;
+FILE *StandardOutput = NULL;
+FILE *StandardError  = NULL;
+
+jmp_buf TopLevelJmpBuf;
+
+bool IsInteractive = false;
+
+
+// Define functions.
+
+
+static double ElapsedSeconds(struct timeval *start)
+{
+    struct timeval end;
+
+    gettimeofday(&end, NULL);
+
+    return (end.tv_sec - start->tv_sec) + (end.tv_usec - start->tv_usec) * 1.0e-6;
+}
+
+// Write a random form nested up to "depth" deep.
+// (Lists are broken over lines now and then, and indented as source code would be.)
+static void WriteForm(FILE *file, int depth)
+{
+    int choice = rand() % 16;
+
+    if ((depth > 0) && (choice < 5)) {
+        int length = 1 + rand() % 6;
+        if (choice == 0)
+          fputc('\'', file);
+        fputc('(', file);
+        for (int index = 0; index < length; index++) {
+            if (index && (rand() % 4))
+              fputc(' ', file);
+            else if (index)
+              fprintf(file, "\n%*s", 2 * (kMaxDepth - depth + 1), "");
+            WriteForm(file, depth - 1);
+        }
+        fputc(')', file);
+    } else if (choice < 10) {
+        int count = 0;
+        while (kSymbols[count])
+          count++;
+        fputs(kSymbols[rand() % count], file);
+    } else if (choice < 13) {
+        fprintf(file, "%d", rand() % 100000 - 50000);
+    } else if (choice < 14) {
+        fprintf(file, "%.6f", rand() / 1000.0);
+    } else if (choice < 15) {
+        fprintf(file, "\"string %d\"", rand() % 1000);
+    } else {
+        fprintf(file, "; A comment, number %d, about the form that follows.\n%*st", rand(), 2 * (kMaxDepth - depth), "");
+    }
+}
+
+// Returns the number of top-level forms written to the file, of about "bytes" bytes.
+static long WriteForms(FILE *file, long bytes)
+{
+    long forms = 0;
+
+    srand(1);
+
+    while (ftell(file) < bytes) {
+        WriteForm(file, kMaxDepth);
+        fputs("\n\n", file);
+        forms++;
+    }
+
+    fflush(file);
+
+    return forms;
+}
+
+// Returns a new temporary file, which is removed once closed.
+static FILE *TemporaryFile(void)
+{
+    char filename[] = "/tmp/psil-reader-benchXXXXXX";
+    int fd;
+    FILE *file = ((fd = mkstemp(filename)) >= 0) ? fdopen(fd, "w+") : NULL;
+
+    if (!file)
+      ErrorOut("ReaderBench:  Failed to create \"%s\"!\n", filename);
+
+    unlink(filename);
+
+    return file;
+}
+
+// Time printing a list of random numbers, and reading it back.
+static void TimeNumbers(long count)
+{
+    FILE *file = TemporaryFile();
+    Form *numbers = SymbolNIL;
+    struct timeval start;
+
+    // (Half are flonums of random bits, and half are integers of random sizes.)
+    srand(2);
+    for (long index = 0; index < count; index++)
+      if (index & 1) {
+          uint32_t bits = ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+          float flonum;
+          memcpy(&flonum, &bits, sizeof(flonum));
+          numbers = Cons(MakeFlonum(isfinite(flonum) ? flonum : 0.0), numbers);
+      } else
+        numbers = Cons(MakeInteger(((PsilInteger) rand() << 31 ^ rand()) >> (rand() % 48)), numbers);
+
+    gettimeofday(&start, NULL);
+
+    Print(numbers, file);
+    fflush(file);
+
+    double seconds = ElapsedSeconds(&start);
+    double size = ftell(file) / (1024.0 * 1024.0);
+
+    printf("Printing and reading %ld numbers (%.1f MB):\n", count, size);
+    printf("%12s %8.3f s %10.1f MB/s\n", "Print", seconds, size / seconds);
+
+    rewind(file);
+    PsilInput *input = OpenInputFile(file);
+
+    gettimeofday(&start, NULL);
+
+    Form *copy = ReadInput(input);
+
+    seconds = ElapsedSeconds(&start);
+
+    printf("%12s %8.3f s %10.1f MB/s  (%s)\n", "Read", seconds, size / seconds,
+           (Equal(numbers, copy) == SymbolT) ? "exact" : "NOT EXACT");
+
+    CloseInput(input);
+    fclose(file);
+}
+
+int main(int argc, char *argv[])
+{
+    long megabytes = (argc > 1) ? atol(argv[1]) : kDefaultMegabytes;
+    long numbers = (argc > 2) ? atol(argv[2]) : kDefaultNumbers;
+    char *token = NULL;
+    size_t tokenSize = 0;
+    struct timeval start;
+
+    StandardInput = stdin;
+    StandardOutput = stdout;
+    StandardError = stderr;
+
+    if ((InitializeHeap(0) != kPsilOK) || (InitializeReader() != kPsilOK))
+      ErrorOut("ReaderBench:  Initialization failed!\n");
+
+    if (setjmp(TopLevelJmpBuf))
+      ErrorOut("ReaderBench:  Read failed!\n");
+
+    FILE *file = TemporaryFile();
+    long forms = WriteForms(file, megabytes * 1024 * 1024);
+    double size = ftell(file) / (1024.0 * 1024.0);
+
+    printf("Reading %.1f MB (%ld forms) with the %s scanner:\n", size, forms, ScanKernelsName());
+
+    // Tokenize the whole file.
+    rewind(file);
+    PsilInput *input = OpenInputFile(file);
+    long tokens = 0;
+
+    gettimeofday(&start, NULL);
+
+    while (ReadToken(input, &token, &tokenSize) != EOF)
+      tokens++;
+
+    double seconds = ElapsedSeconds(&start);
+
+    CloseInput(input);
+    free((void *) token);
+    printf("%12s %10ld tokens %8.3f s %10.1f MB/s\n", "ReadToken", tokens, seconds, size / seconds);
+
+    // Read the whole file as forms.
+    rewind(file);
+    input = OpenInputFile(file);
+
+    gettimeofday(&start, NULL);
+
+    for (long index = 0; index < forms; index++) {
+        ReadInput(input);
+        // (Nothing is evaluated, so collect when requested to free the forms read.)
+        if (GCRequested)
+          CollectGarbage();
+    }
+
+    seconds = ElapsedSeconds(&start);
+
+    CloseInput(input);
+    printf("%12s %10ld forms  %8.3f s %10.1f MB/s\n", "Read", forms, seconds, size / seconds);
+
+    fclose(file);
+
+    TimeNumbers(numbers);
+
+    DeInitializeReader();
+    DeInitializeHeap();
+
+    return 0;
+}